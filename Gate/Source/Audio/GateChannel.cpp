@@ -0,0 +1,350 @@
+#include "GateChannel.h"
+
+//======================================================================================================================
+GateChannel::GateChannel(double currentSampleRate, int maximumBlockSize, std::size_t delayLineCapacity)
+    :   sampleRate(currentSampleRate),
+        peakFollower(static_cast<float>(currentSampleRate)),
+        delayLine(delayLineCapacity),
+        windowMaximum(delayLineCapacity + 1)
+{
+    // We'll use an attack time of 0ms so that the envelope instantly jumps up
+    // to match peaks. A release time of 100ms means the envelope will be
+    // smoothed a bit but will still closely follow the envelope of the audio
+    // signal.
+    peakFollower.setAttackTime(0.f);
+    peakFollower.setReleaseTime(100.f);
+
+    const auto blockSize = static_cast<std::size_t>(juce::jmax(1, maximumBlockSize));
+    delayedInput.resize(blockSize);
+    keyInput.resize(blockSize);
+    envelope.resize(blockSize);
+    envelopeMaximum.resize(blockSize);
+    gains.resize(blockSize);
+}
+
+//======================================================================================================================
+void GateChannel::setDelayLength(std::size_t newLength)
+{
+    delayLine.setLength(newLength);
+
+    // The delay line is read before it's written to, so the delayed input is
+    // actually one sample older than its length. The window covers every
+    // sample from that one to the newest.
+    windowLength = newLength + 2;
+}
+
+void GateChannel::setKeyFilters(float highPassFrequency, float lowPassFrequency)
+{
+    updateKeyFilter(keyHighPass, isKeyHighPassActive, highPassFrequency, true);
+    updateKeyFilter(keyLowPass, isKeyLowPassActive, lowPassFrequency, false);
+}
+
+void GateChannel::process(float* samples, int numSamples, float openThreshold, float closeThreshold,
+                          float attackInMS, float releaseInMS, const GateCurve& curve, bool isBypassed)
+{
+    const auto maxBlockSize = static_cast<int>(gains.size());
+
+    for (auto start = 0; start < numSamples; start += maxBlockSize)
+    {
+        processBlock(samples + start, juce::jmin(maxBlockSize, numSamples - start), openThreshold, closeThreshold,
+                     attackInMS, releaseInMS, curve, isBypassed);
+    }
+}
+
+float GateChannel::getGain() const noexcept
+{
+    return lastGain;
+}
+
+void GateChannel::reset()
+{
+    peakFollower.reset();
+    delayLine.reset();
+    windowMaximum.reset();
+
+    for (auto& biquad : keyHighPass)
+        biquad.reset();
+
+    for (auto& biquad : keyLowPass)
+        biquad.reset();
+
+    state = State::Closed;
+    rampValue = 0.f;
+    rampTarget = 0.f;
+    rampStep = 0.f;
+    numRampSamplesRemaining = 0;
+    numSamplesUntilSettled = 0;
+    numSamplesUntilWindowFilled = 0;
+    lastGain = 0.f;
+}
+
+//======================================================================================================================
+void GateChannel::processBlock(float* samples, int numSamples, float openThreshold, float closeThreshold,
+                               float attackInMS, float releaseInMS, const GateCurve& curve, bool isBypassed)
+{
+    windowMaximum.setLength(windowLength);
+
+    // With a close threshold of zero (a threshold of -INF) an open gate can
+    // never close, so the output is just the delayed input and there's
+    // nothing to look for in the envelope.
+    if (closeThreshold <= 0.f && state == State::Open && isSettled())
+    {
+        processNeutral(samples, numSamples, isBypassed);
+        return;
+    }
+
+    followEnvelopes(samples, numSamples);
+
+    // Most of the time the gate stays fully open or fully closed for a whole
+    // block, in which case the output is just the delayed input or silence.
+    if (isSettled() && findNextStateChange(0, numSamples, openThreshold, closeThreshold) == numSamples)
+    {
+        lastGain = state == State::Open ? 1.f : 0.f;
+        numSamplesUntilWindowFilled = juce::jmax(0, numSamplesUntilWindowFilled - numSamples);
+
+        if (isBypassed)
+            return;
+
+        if (state == State::Open)
+            juce::FloatVectorOperations::copy(samples, delayedInput.data(), numSamples);
+        else
+            juce::FloatVectorOperations::clear(samples, numSamples);
+
+        return;
+    }
+
+    // Generate the gains a segment at a time, from one change of state to
+    // the next.
+    for (auto position = 0; position < numSamples;)
+    {
+        const auto stateChange = findNextStateChange(position, numSamples, openThreshold, closeThreshold);
+        advanceRamp(gains.data() + position, stateChange - position);
+        position = stateChange;
+
+        // An opening or closing gate settles once its ramp is close enough to
+        // the target. This allows for any precision loss where the gain
+        // might not be exactly 0 or 1 when the ramp finishes.
+        if ((state == State::Opening || state == State::Closing) && numSamplesUntilSettled == 0)
+        {
+            state = state == State::Opening ? State::Open : State::Closed;
+            continue;
+        }
+
+        if (position == numSamples)
+            break;
+
+        // Otherwise the envelopes have crossed the threshold.
+        if (state == State::Open)
+        {
+            state = State::Closing;
+            startRamp(0.f, releaseInMS, curve);
+        }
+        else
+        {
+            state = State::Opening;
+            startRamp(1.f, attackInMS, curve);
+        }
+    }
+
+    // Map the ramp's values to gains using the curve.
+    curve.apply(gains.data(), numSamples);
+    lastGain = gains[static_cast<std::size_t>(numSamples - 1)];
+    numSamplesUntilWindowFilled = juce::jmax(0, numSamplesUntilWindowFilled - numSamples);
+
+    // Apply the gains to the delayed input.
+    if (!isBypassed)
+        juce::FloatVectorOperations::multiply(samples, delayedInput.data(), gains.data(), numSamples);
+}
+
+void GateChannel::processNeutral(float* samples, int numSamples, bool isBypassed)
+{
+    // The envelope is still followed, so it's up to date when the threshold
+    // is raised, but finding its maximum is skipped. That leaves the window
+    // empty, so the gate is held open until it's been refilled, otherwise
+    // the gate could close before a peak that's still in the delay line.
+    delayLine.process(samples, delayedInput.data(), static_cast<std::size_t>(numSamples));
+    followEnvelope(samples, numSamples);
+
+    windowMaximum.reset();
+    numSamplesUntilWindowFilled = static_cast<int>(windowLength.load());
+    lastGain = 1.f;
+
+    if (!isBypassed)
+        juce::FloatVectorOperations::copy(samples, delayedInput.data(), numSamples);
+}
+
+void GateChannel::followEnvelopes(const float* input, int numSamples)
+{
+    // The delayed input is the input N samples ago when we have N samples of
+    // latency (AKA the actual 'live' sample).
+    delayLine.process(input, delayedInput.data(), static_cast<std::size_t>(numSamples));
+    followEnvelope(input, numSamples);
+
+    windowMaximum.process(envelope.data(), envelopeMaximum.data(), static_cast<std::size_t>(numSamples));
+}
+
+void GateChannel::followEnvelope(const float* input, int numSamples)
+{
+    // Only the detected signal is filtered, so it's copied first. With both
+    // filters off the input is used as it is.
+    const auto* key = input;
+
+    if (isKeyHighPassActive || isKeyLowPassActive)
+    {
+        juce::FloatVectorOperations::copy(keyInput.data(), input, numSamples);
+
+        if (isKeyHighPassActive)
+            applyKeyFilter(keyHighPass, keyInput.data(), numSamples);
+
+        if (isKeyLowPassActive)
+            applyKeyFilter(keyLowPass, keyInput.data(), numSamples);
+
+        key = keyInput.data();
+    }
+
+    // The envelope follows the non delayed signal and so is ahead of time
+    // since we've told the host we're introducing some latency.
+    for (auto i = 0; i < numSamples; i++)
+        envelope[static_cast<std::size_t>(i)] = peakFollower.processSample(key[i]);
+}
+
+void GateChannel::updateKeyFilter(KeyFilter& filter, bool& isActive, float frequency, bool isHighPass)
+{
+    if (frequency <= 0.f)
+    {
+        isActive = false;
+        return;
+    }
+
+    // Don't carry over whatever was left in the filter from the last time it
+    // was used.
+    if (!isActive)
+    {
+        for (auto& biquad : filter)
+            biquad.reset();
+    }
+
+    isActive = true;
+
+    // The Q of each stage of a 4th order Butterworth filter.
+    constexpr std::array<double, 2> qs{ 0.5412, 1.3066 };
+
+    for (std::size_t stage = 0; stage < filter.size(); stage++)
+    {
+        filter[stage].setCoefficients(
+            isHighPass ? contrast::Biquad<float>::makeHighPass(sampleRate, frequency, qs[stage])
+                       : contrast::Biquad<float>::makeLowPass(sampleRate, frequency, qs[stage]));
+    }
+}
+
+void GateChannel::applyKeyFilter(KeyFilter& filter, float* samples, int numSamples)
+{
+    for (auto& biquad : filter)
+        biquad.process(samples, numSamples);
+}
+
+bool GateChannel::isSettled() const
+{
+    if (numRampSamplesRemaining > 0)
+        return false;
+
+    return (state == State::Open && rampValue == 1.f) || (state == State::Closed && rampValue == 0.f);
+}
+
+int GateChannel::findNextStateChange(int start, int end, float openThreshold, float closeThreshold) const
+{
+    switch (state)
+    {
+        case State::Opening:
+            // Nothing can interrupt the gate while it's opening.
+            return juce::jmin(end, start + numSamplesUntilSettled);
+
+        case State::Closing:
+            end = juce::jmin(end, start + numSamplesUntilSettled);
+            [[fallthrough]];
+
+        case State::Closed:
+            // Start opening the gate when the envelope (ahead of time) goes
+            // above the threshold.
+            for (auto i = start; i < end; i++)
+            {
+                if (envelope[static_cast<std::size_t>(i)] > openThreshold)
+                    return i;
+            }
+
+            return end;
+
+        case State::Open:
+        default:
+            // Don't start closing the gate again until the envelope has been
+            // below the threshold for the whole look-ahead window, from the
+            // sample being output to the newest. This keeps the gate open for
+            // any peak that's either playing or about to. If the window's
+            // still filling up, it can't be trusted until it's full.
+            for (auto i = juce::jmax(start, numSamplesUntilWindowFilled); i < end; i++)
+            {
+                if (envelopeMaximum[static_cast<std::size_t>(i)] < closeThreshold)
+                    return i;
+            }
+
+            return end;
+    }
+}
+
+//======================================================================================================================
+void GateChannel::startRamp(float target, float timeInMS, const GateCurve& curve)
+{
+    // This matches juce::SmoothedValue's linear ramps.
+    const auto numSteps = static_cast<int>(std::floor(timeInMS * 0.001 * sampleRate));
+
+    rampTarget = target;
+
+    if (numSteps <= 0 || rampValue == target)
+    {
+        rampValue = target;
+        numRampSamplesRemaining = 0;
+        numSamplesUntilSettled = 1;
+        return;
+    }
+
+    rampStep = (target - rampValue) / static_cast<float>(numSteps);
+    numRampSamplesRemaining = numSteps;
+
+    // Find the first sample where the gain is at least 0.999 when opening or
+    // below 0.001 when closing.
+    const auto settledValue = target > 0.f ? curve.getOpenValue() : curve.getClosedValue();
+    const auto numStepsToSettle = target > 0.f ? std::ceil((settledValue - rampValue) / rampStep)
+                                               : std::floor((settledValue - rampValue) / rampStep) + 1.f;
+
+    numSamplesUntilSettled = juce::jlimit(1, numSteps, static_cast<int>(numStepsToSettle));
+}
+
+void GateChannel::advanceRamp(float* values, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const auto numRampSamples = juce::jmin(numSamples, numRampSamplesRemaining);
+
+    for (auto i = 0; i < numRampSamples; i++)
+        values[i] = rampValue + rampStep * static_cast<float>(i + 1);
+
+    numRampSamplesRemaining -= numRampSamples;
+
+    // The last step of the ramp always lands exactly on the target.
+    if (numRampSamplesRemaining == 0)
+    {
+        rampValue = rampTarget;
+
+        if (numRampSamples > 0)
+            values[numRampSamples - 1] = rampTarget;
+
+        juce::FloatVectorOperations::fill(values + numRampSamples, rampTarget, numSamples - numRampSamples);
+    }
+    else
+    {
+        rampValue = values[numRampSamples - 1];
+    }
+
+    numSamplesUntilSettled = juce::jmax(0, numSamplesUntilSettled - numSamples);
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "GateCurve.h"
+
+//======================================================================================================================
+/** Gates a single channel of audio, using a look-ahead so the gate can be
+    fully open by the time the peak that opened it arrives.
+
+    A single envelope follows the input, ahead of time thanks to the
+    look-ahead. The gate opens as soon as that envelope goes above the
+    threshold, and closes once the maximum of the envelope over the whole
+    look-ahead window, from the sample being output up to the newest one, has
+    fallen below the threshold.
+
+    Rather than stepping the gate's state machine one sample at a time, each
+    block is processed in passes:
+    - The envelope and its maximum over the look-ahead window are found.
+    - The block is split into segments between the points where the gate's
+      state changes, and the gain ramp for each segment is generated in one
+      go.
+    - The gains are applied to the delayed input with a single vectorised
+      multiply.
+
+    When the gate stays fully open or fully closed for the whole block, the
+    last two passes are skipped and the delayed input is copied or the output
+    cleared instead. With the threshold at -INF, an open gate can't close, so
+    the look-ahead window's maximum isn't searched either.
+*/
+class GateChannel
+{
+public:
+    //==================================================================================================================
+    GateChannel(double sampleRate, int maximumBlockSize, std::size_t delayLineCapacity);
+
+    //==================================================================================================================
+    /** Sets the length, in samples, of the look-ahead delay. */
+    void setDelayLength(std::size_t);
+
+    /** Sets the cutoff frequencies of the filters applied to the signal the
+        gate detects, but not to the signal it gates. Either filter can be
+        turned off by giving a frequency of zero.
+
+        This should be called from the audio thread.
+    */
+    void setKeyFilters(float highPassFrequency, float lowPassFrequency);
+
+    /** Gates the given samples in place. When bypassed, the gate's state is
+        still updated but the samples are left untouched.
+
+        The thresholds are linear gains. The gate opens when the envelope goes
+        above the open threshold, and closes once the envelope has been below
+        the close threshold for the whole look-ahead window. The curve sets
+        the shape of the gate's ramps.
+    */
+    void process(float* samples, int numSamples, float openThreshold, float closeThreshold, float attackInMS,
+                 float releaseInMS, const GateCurve& curve, bool isBypassed);
+
+    /** Returns the gain the gate applied to the last sample processed. */
+    float getGain() const noexcept;
+
+    /** Closes the gate and clears everything it's been listening to, as if
+        it had just been created.
+    */
+    void reset();
+
+private:
+    //==================================================================================================================
+    // When the gate is opening, it isn't allowed to start closing again until
+    // it's fully open, otherwise peaks might not get the full gain.
+    enum class State
+    {
+        Closed,
+        Opening,
+        Open,
+        Closing
+    };
+
+    //==================================================================================================================
+    /** Processes a block no longer than the maximum block size. */
+    void processBlock(float* samples, int numSamples, float openThreshold, float closeThreshold, float attackInMS,
+                      float releaseInMS, const GateCurve& curve, bool isBypassed);
+
+    /** Processes a block while the gate is open and can't close, which only
+        needs to delay the input.
+    */
+    void processNeutral(float* samples, int numSamples, bool isBypassed);
+
+    /** Fills the delayed input, the envelope of the given input, after
+        applying the key filters, and the envelope's maximum over the
+        look-ahead window.
+    */
+    void followEnvelopes(const float* input, int numSamples);
+
+    /** Fills the envelope of the given input, after applying the key
+        filters.
+    */
+    void followEnvelope(const float* input, int numSamples);
+
+    /** Returns the index of the first sample, from start, at which the gate's
+        state changes, or end if it doesn't change before then.
+    */
+    int findNextStateChange(int start, int end, float openThreshold, float closeThreshold) const;
+
+    /** Returns true if the gate is fully open or fully closed and isn't
+        ramping.
+    */
+    bool isSettled() const;
+
+    /** Starts ramping the gate towards the given value over the given time,
+        with the given curve deciding when the gate has settled.
+    */
+    void startRamp(float target, float timeInMS, const GateCurve& curve);
+
+    /** Writes the next values of the current ramp to the given buffer. */
+    void advanceRamp(float* values, int numSamples);
+
+    //==================================================================================================================
+    const double sampleRate;
+
+    // Each key filter is two biquads, giving a 24dB/octave Butterworth
+    // response.
+    using KeyFilter = std::array<contrast::Biquad<float>, 2>;
+
+    /** Sets the coefficients of a key filter, resetting it if it was off. */
+    void updateKeyFilter(KeyFilter&, bool& isActive, float frequency, bool isHighPass);
+
+    /** Applies a key filter to the given samples. */
+    static void applyKeyFilter(KeyFilter&, float* samples, int numSamples);
+
+    //==================================================================================================================
+    // Follows the peaks of the non delayed input.
+    contrast::EnvelopeFollower peakFollower;
+
+    // The filters applied to the detected signal, which are skipped entirely
+    // while they're off.
+    KeyFilter keyHighPass;
+    KeyFilter keyLowPass;
+    bool isKeyHighPassActive = false;
+    bool isKeyLowPassActive = false;
+
+    // The delay line that allows us to use a look-ahead technique.
+    contrast::DelayLine<float> delayLine;
+
+    // Finds the loudest the envelope gets over the look-ahead window. The
+    // window's length is set from the message thread but only applied at the
+    // start of each block.
+    contrast::SlidingWindowMaximum<float> windowMaximum;
+    std::atomic<std::size_t> windowLength{ 1 };
+
+    State state = State::Closed;
+
+    // The linear ramp the gate is currently following, which is the same as
+    // a juce::SmoothedValue but generated a segment at a time. The gain
+    // applied is the ramp's value mapped through the gate's curve.
+    float rampValue = 0.f;
+    float rampTarget = 0.f;
+    float rampStep = 0.f;
+    int numRampSamplesRemaining = 0;
+
+    // The number of samples until an opening or closing gate is considered
+    // to be fully open or closed.
+    int numSamplesUntilSettled = 0;
+
+    // The gain applied to the last sample processed.
+    float lastGain = 0.f;
+
+    // The number of samples, from the start of the next block, until the
+    // window maximum covers the whole look-ahead window again after being
+    // skipped.
+    int numSamplesUntilWindowFilled = 0;
+
+    // Scratch buffers for each pass over the block.
+    std::vector<float> delayedInput;
+    std::vector<float> keyInput;
+    std::vector<float> envelope;
+    std::vector<float> envelopeMaximum;
+    std::vector<float> gains;
+
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateChannel)
+};
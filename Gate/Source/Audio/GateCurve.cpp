@@ -0,0 +1,89 @@
+#include "GateCurve.h"
+
+//======================================================================================================================
+GateCurve::GateCurve(Shape curveShape)
+    :   shape(curveShape)
+{
+    // Plenty of points so the steep start of the square root curve is still
+    // accurate, apart from the first segment which is calculated directly.
+    table.initialise([this](float value) { return calculateGain(shape, value); }, 0.f, 1.f, numTablePoints);
+
+    openValue = findValueForGain(shape, 0.999f);
+    closedValue = findValueForGain(shape, 0.001f);
+}
+
+//======================================================================================================================
+void GateCurve::apply(float* values, int numValues) const
+{
+    // A linear curve leaves the ramp as it is.
+    if (shape == Shape::Linear)
+        return;
+
+    // Interpolating the first segment of the square root curve linearly from
+    // 0 would make the gain far too low at the quiet end of the ramp, where
+    // the curve is steepest, so those values use the square root itself.
+    if (shape == Shape::SquareRoot)
+    {
+        constexpr auto firstSegmentEnd = 1.f / static_cast<float>(numTablePoints - 1);
+
+        for (auto i = 0; i < numValues; i++)
+            values[i] = values[i] < firstSegmentEnd ? std::sqrt(values[i]) : table.processSample(values[i]);
+
+        return;
+    }
+
+    table.process(values, values, static_cast<std::size_t>(numValues));
+}
+
+float GateCurve::getOpenValue() const noexcept
+{
+    return openValue;
+}
+
+float GateCurve::getClosedValue() const noexcept
+{
+    return closedValue;
+}
+
+//======================================================================================================================
+float GateCurve::calculateGain(Shape curveShape, float value)
+{
+    switch (curveShape)
+    {
+        case Shape::Linear:
+            return value;
+
+        case Shape::Exponential:
+        {
+            // Linear in decibels from -60dB up to 0dB, offset so the gain
+            // still reaches exactly 0 when the gate's fully closed.
+            constexpr auto floor = 0.001f;
+            return (std::pow(10.f, 3.f * (value - 1.f)) - floor) / (1.f - floor);
+        }
+
+        case Shape::SquareRoot:
+        default:
+            // The square root of a linear ramp means the slope is more linear
+            // when converted to decibels.
+            return std::sqrt(value);
+    }
+}
+
+float GateCurve::findValueForGain(Shape curveShape, float gain)
+{
+    // The curves all rise from 0 to 1 so a binary search will find the value.
+    auto low = 0.f;
+    auto high = 1.f;
+
+    for (auto i = 0; i < 32; i++)
+    {
+        const auto middle = (low + high) * 0.5f;
+
+        if (calculateGain(curveShape, middle) < gain)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return high;
+}
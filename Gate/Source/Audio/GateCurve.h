@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//======================================================================================================================
+/** The shape of the gain ramps used when a gate opens and closes.
+
+    The gates ramp a value linearly from 0 to 1, or 1 to 0, over the attack or
+    release time. A curve maps that value to the gain that's actually applied,
+    using a precomputed table so no maths functions are needed per sample,
+    except at the very start of the square root curve where a table isn't
+    accurate enough.
+*/
+class GateCurve
+{
+public:
+    //==================================================================================================================
+    enum class Shape
+    {
+        Linear,
+        SquareRoot,
+        Exponential
+    };
+
+    //==================================================================================================================
+    explicit GateCurve(Shape);
+
+    //==================================================================================================================
+    /** Replaces the given ramp values, from 0 to 1, with their gains. */
+    void apply(float* values, int numValues) const;
+
+    /** Returns the ramp value at which the gain reaches 0.999, so an opening
+        gate can be considered fully open.
+    */
+    float getOpenValue() const noexcept;
+
+    /** Returns the ramp value below which the gain is less than 0.001, so a
+        closing gate can be considered fully closed.
+    */
+    float getClosedValue() const noexcept;
+
+private:
+    //==================================================================================================================
+    /** Returns the gain for the given ramp value. */
+    static float calculateGain(Shape, float value);
+
+    /** Returns the ramp value at which the curve reaches the given gain. */
+    static float findValueForGain(Shape, float gain);
+
+    //==================================================================================================================
+    static constexpr int numTablePoints = 4096;
+
+    const Shape shape;
+    juce::dsp::LookupTableTransform<float> table;
+
+    float openValue = 1.f;
+    float closedValue = 0.f;
+
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateCurve)
+};
@@ -7,51 +7,56 @@ GateProcessor::GateProcessor()
     :   contrast::PluginProcessor(createParameterLayout(), createDefaultProperties()),
         threshold(*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::THRESHOLD))),
         attack(   *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::ATTACK))),
-        release(  *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::RELEASE)))
+        release(  *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::RELEASE))),
+        curve(    *dynamic_cast<juce::AudioParameterChoice*>(getAPVTS().getParameter(Gate::ParameterIDs::CURVE))),
+        keyHighPass(*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::KEY_HIGH_PASS))),
+        keyLowPass( *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::KEY_LOW_PASS))),
+        bands(      *dynamic_cast<juce::AudioParameterInt*>(getAPVTS().getParameter(Gate::ParameterIDs::BANDS))),
+        crossoverLow( *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::CROSSOVER_LOW))),
+        crossoverMid( *dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::CROSSOVER_MID))),
+        crossoverHigh(*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Gate::ParameterIDs::CROSSOVER_HIGH))),
+        curves{
+            std::make_unique<GateCurve>(GateCurve::Shape::Linear),
+            std::make_unique<GateCurve>(GateCurve::Shape::SquareRoot),
+            std::make_unique<GateCurve>(GateCurve::Shape::Exponential)
+        }
 {
     // Need to listen for changes to the attack parameter so we can change the
-    // length of the delay lines accordingly.
+    // length of the delay lines accordingly, to the threshold so we can
+    // convert it to a gain, and to the key filters and bands so their
+    // coefficients are only calculated when they change.
     getAPVTS().addParameterListener(Gate::ParameterIDs::ATTACK, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::THRESHOLD, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::KEY_HIGH_PASS, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::KEY_LOW_PASS, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::BANDS, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::CROSSOVER_LOW, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::CROSSOVER_MID, this);
+    getAPVTS().addParameterListener(Gate::ParameterIDs::CROSSOVER_HIGH, this);
+
+    updateThresholds();
 }
 
 GateProcessor::~GateProcessor()
 {
     // Make sure to remove this as a listener to the APVTS.
     getAPVTS().removeParameterListener(Gate::ParameterIDs::ATTACK, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::THRESHOLD, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::KEY_HIGH_PASS, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::KEY_LOW_PASS, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::BANDS, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::CROSSOVER_LOW, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::CROSSOVER_MID, this);
+    getAPVTS().removeParameterListener(Gate::ParameterIDs::CROSSOVER_HIGH, this);
 }
 
 //======================================================================================================================
-void GateProcessor::prepareToPlay(double sampleRate, int /* blockSize */)
+void GateProcessor::prepareToPlay(double /* sampleRate */, int /* blockSize */)
 {
-    // Make sure the vectors have been resized to fit the current number of
-    // channels.
+    // Make sure the gates have been created for the current number of
+    // channels, sample rate and block size.
     numChannelsChanged();
 
-    // Initialise the current peak followers
-    for (auto& follower : currentPeakFollowers)
-    {
-        follower.reset(new contrast::EnvelopeFollower(static_cast<float>(sampleRate)));
-        jassert(follower);
-
-        // We'll use an attack time of 0ms so that the envelope instantly jumps
-        // up to match peaks.
-        follower->setAttackTime(0.f);
-
-        // A release time of 100ms means the envelope will be smoothed a bit but
-        // will still closely follow the envelope of the audio signal.
-        follower->setReleaseTime(100.f);
-    }
-
-    // Initialise the delayed peak followers
-    for (auto& follower : delayedPeakFollowers)
-    {
-        follower.reset(new contrast::EnvelopeFollower(static_cast<float>(sampleRate)));
-        jassert(follower);
-
-        follower->setAttackTime(0.f);
-        follower->setReleaseTime(100.f);
-    }
-
     updateDelayLines();
 }
 
@@ -67,12 +72,9 @@ void GateProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce:
 
 void GateProcessor::releaseResources()
 {
-    // Clear all the vectors.
-    currentPeakFollowers  .clear();
-    delayedPeakFollowers  .clear();
-    gates                 .clear();
-    delayLines            .clear();
-    gateStates            .clear();
+    gateChannels.clear();
+    crossovers.clear();
+    bandBuffer.setSize(0, 0);
 }
 
 void GateProcessor::numChannelsChanged()
@@ -83,16 +85,31 @@ void GateProcessor::numChannelsChanged()
     const auto numChannels = static_cast<std::size_t> (juce::jmax(getTotalNumInputChannels(),
                                                                   getTotalNumOutputChannels()));
 
-    currentPeakFollowers  .resize(numChannels);
-    delayedPeakFollowers  .resize(numChannels);
-    gates                 .resize(numChannels);
-    gateStates            .resize(numChannels);
-    delayLines            .resize(numChannels);
+    gateChannels.resize(numChannels);
+    crossovers.resize(numChannels);
 
     const auto capacity = contrast::ceil<std::size_t>(Gate::releaseMax<double> * getSampleRate() * 0.001);
 
-    for (auto& delayLine : delayLines)
-        delayLine.reset(new contrast::DelayLine<float>(capacity));
+    for (auto& bandGates : gateChannels)
+    {
+        for (auto& gateChannel : bandGates)
+            gateChannel.reset(new GateChannel(getSampleRate(), getBlockSize(), capacity));
+    }
+
+    for (auto& crossover : crossovers)
+        crossover.reset(new contrast::LinkwitzRileyCrossover(getSampleRate(), getBlockSize()));
+
+    bandBuffer.setSize(Gate::maxBands, juce::jmax(1, getBlockSize()));
+
+    // The new gates and crossovers need their filters setting up.
+    keyFiltersChanged = true;
+    crossoversChanged = true;
+}
+
+//======================================================================================================================
+contrast::LockFreeFifo<GateProcessor::ActivitySummary>& GateProcessor::getActivityFifo() noexcept
+{
+    return activityFifo;
 }
 
 //======================================================================================================================
@@ -167,6 +184,12 @@ void GateProcessor::parameterChanged(const juce::String& parameterID, float /* n
     // Update the delay lines when the attack parameter changes.
     if (parameterID == Gate::ParameterIDs::ATTACK)
         updateDelayLines();
+    else if (parameterID == Gate::ParameterIDs::THRESHOLD)
+        updateThresholds();
+    else if (parameterID == Gate::ParameterIDs::KEY_HIGH_PASS || parameterID == Gate::ParameterIDs::KEY_LOW_PASS)
+        keyFiltersChanged = true;
+    else
+        crossoversChanged = true;
 }
 
 //======================================================================================================================
@@ -245,6 +268,126 @@ juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParamet
                 return value;
             }));
 
+    // The shape of the gate's ramps as it opens and closes. The square root
+    // curve is the original shape, and is more linear in decibels than a
+    // linear ramp.
+    auto curveParam = std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{
+            Gate::ParameterIDs::CURVE,
+            1,
+        },
+        "Curve",
+        juce::StringArray{ "Linear", "Sqrt", "Exponential" },
+        1);
+
+    // The key filters only affect the signal the gate listens to, so that, for
+    // example, a kick drum bleeding into a snare mic doesn't open the gate.
+    // Each is off at its end of the range.
+    auto keyFrequencyRange = juce::NormalisableRange<float>(Gate::keyFrequencyMin<float>, Gate::keyFrequencyMax<float>);
+    keyFrequencyRange.setSkewForCentre(1000.f);
+
+    auto frequencyToString = [](float value, int) -> juce::String {
+        if (value <= Gate::keyFrequencyMin<float> || value >= Gate::keyFrequencyMax<float>)
+            return "OFF";
+
+        if (value < 1000.f)
+            return contrast::pretifyValue(value, 3) + "Hz";
+
+        // Display as kHz if the value is over 1000 Hz
+        return contrast::pretifyValue(value / 1000.f, 3) + "kHz";
+    };
+
+    auto keyHighPassParam = std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{
+            Gate::ParameterIDs::KEY_HIGH_PASS,
+            1,
+        },
+        "Key HPF",
+        keyFrequencyRange,
+        Gate::keyFrequencyMin<float>,
+        juce::AudioParameterFloatAttributes{}
+            .withStringFromValueFunction(frequencyToString)
+            .withValueFromStringFunction([](const juce::String& text) -> float {
+                if (text.trim().equalsIgnoreCase("OFF"))
+                    return Gate::keyFrequencyMin<float>;
+
+                if (text.endsWithIgnoreCase("kHz"))
+                    return text.getFloatValue() * 1000.f;
+
+                return text.getFloatValue();
+            }));
+
+    auto keyLowPassParam = std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{
+            Gate::ParameterIDs::KEY_LOW_PASS,
+            1,
+        },
+        "Key LPF",
+        keyFrequencyRange,
+        Gate::keyFrequencyMax<float>,
+        juce::AudioParameterFloatAttributes{}
+            .withStringFromValueFunction(frequencyToString)
+            .withValueFromStringFunction([](const juce::String& text) -> float {
+                if (text.trim().equalsIgnoreCase("OFF"))
+                    return Gate::keyFrequencyMax<float>;
+
+                if (text.endsWithIgnoreCase("kHz"))
+                    return text.getFloatValue() * 1000.f;
+
+                return text.getFloatValue();
+            }));
+
+    // The signal can be split into several bands which are each gated
+    // separately, so, for example, a hi-hat can open the gate for the high
+    // frequencies without letting through the low rumble underneath it.
+    auto bandsParam = std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{
+            Gate::ParameterIDs::BANDS,
+            1,
+        },
+        "Bands",
+        1,
+        Gate::maxBands,
+        1);
+
+    // The frequencies the bands are split at, over the same range as the key
+    // filters. The crossovers are kept in order when they're used, so they
+    // can be set freely.
+    auto crossoverRange = juce::NormalisableRange<float>(Gate::keyFrequencyMin<float>, Gate::keyFrequencyMax<float>);
+    crossoverRange.setSkewForCentre(1000.f);
+
+    auto crossoverToString = [](float value, int) -> juce::String {
+        if (value < 1000.f)
+            return contrast::pretifyValue(value, 3) + "Hz";
+
+        return contrast::pretifyValue(value / 1000.f, 3) + "kHz";
+    };
+
+    auto crossoverFromString = [](const juce::String& text) -> float {
+        if (text.endsWithIgnoreCase("kHz"))
+            return text.getFloatValue() * 1000.f;
+
+        return text.getFloatValue();
+    };
+
+    auto createCrossoverParam = [&](const char* parameterID, const juce::String& name, float defaultValue) {
+        return std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{
+                parameterID,
+                1,
+            },
+            name,
+            crossoverRange,
+            defaultValue,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction(crossoverToString)
+                .withValueFromStringFunction(crossoverFromString));
+    };
+
+    auto crossoverLowParam  = createCrossoverParam(Gate::ParameterIDs::CROSSOVER_LOW,  "Low X-Over",  150.f);
+    auto crossoverMidParam  = createCrossoverParam(Gate::ParameterIDs::CROSSOVER_MID,  "Mid X-Over",  1500.f);
+    auto crossoverHighParam = createCrossoverParam(Gate::ParameterIDs::CROSSOVER_HIGH, "High X-Over", 6000.f);
+
     // In this plugin we only have one, unnamed group that all of our parameters
     // we live in.
     std::vector<std::unique_ptr<juce::AudioProcessorParameterGroup>> groups;
@@ -252,7 +395,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParamet
         "gate", "Gate", "",
         std::move(thresholdParam),
         std::move(attackParam),
-        std::move(releaseParam)
+        std::move(releaseParam),
+        std::move(curveParam),
+        std::move(keyHighPassParam),
+        std::move(keyLowPassParam),
+        std::move(bandsParam),
+        std::move(crossoverLowParam),
+        std::move(crossoverMidParam),
+        std::move(crossoverHighParam)
     ));
 
     return { groups.begin(), groups.end() };
@@ -270,12 +420,27 @@ void GateProcessor::process(juce::AudioBuffer<float>& buffer, bool isBypassed)
     const juce::ScopedNoDenormals noDenormals;
 
     const auto numChannels = static_cast<std::size_t>(buffer.getNumChannels());
-    const auto numSamples = static_cast<std::size_t>(buffer.getNumSamples());
+    const auto numSamples = buffer.getNumSamples();
+
+    jassert(gateChannels.size() >= numChannels);
+
+    // Find the range of the input before it's gated, for the display.
+    auto inputRange = juce::Range<float>{};
+
+    for (std::size_t channel = 0; channel < numChannels; channel++)
+    {
+        const auto channelRange = juce::FloatVectorOperations::findMinAndMax(
+            buffer.getReadPointer(static_cast<int>(channel)), numSamples);
+        inputRange = channel == 0 ? channelRange : inputRange.getUnionWith(channelRange);
+    }
+
+    const auto& gateCurve = *curves[static_cast<std::size_t>(juce::jlimit(0, 2, curve.getIndex()))];
 
-    jassert(currentPeakFollowers.size() >= numChannels);
-    jassert(delayedPeakFollowers.size() >= numChannels);
+    if (keyFiltersChanged.exchange(false))
+        updateKeyFilters();
 
-    const auto sampleRate = getSampleRate();
+    if (crossoversChanged.exchange(false))
+        updateCrossovers();
 
     // Make sure to tell the host how much delay our plugin is introducing so
     // it can act accordingly.
@@ -283,83 +448,111 @@ void GateProcessor::process(juce::AudioBuffer<float>& buffer, bool isBypassed)
 
     for (std::size_t channel = 0; channel < numChannels; channel++)
     {
-        auto channelData = buffer.getWritePointer(static_cast<int>(channel));
+        auto* samples = buffer.getWritePointer(static_cast<int>(channel));
 
-        jassert(currentPeakFollowers[channel] != nullptr);
-        jassert(delayedPeakFollowers[channel] != nullptr);
-        jassert(delayLines[channel]           != nullptr);
+        if (numBands > 1)
+        {
+            processBands(channel, samples, numSamples, gateCurve, isBypassed);
+            continue;
+        }
 
-        for (std::size_t i = 0; i < numSamples; i++)
+        jassert(gateChannels[channel][0] != nullptr);
+
+        gateChannels[channel][0]->process(samples, numSamples, openThreshold, closeThreshold, attack, release,
+                                          gateCurve, isBypassed);
+    }
+
+    updateActivity(inputRange, numSamples);
+}
+
+void GateProcessor::processBands(std::size_t channel, float* samples, int numSamples, const GateCurve& gateCurve,
+                                 bool isBypassed)
+{
+    jassert(crossovers[channel] != nullptr);
+
+    auto& crossover = *crossovers[channel];
+    auto& bandGates = gateChannels[channel];
+    auto* const* bandSamples = bandBuffer.getArrayOfWritePointers();
+    const auto maxBlockSize = bandBuffer.getNumSamples();
+
+    for (auto start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const auto blockSize = juce::jmin(maxBlockSize, numSamples - start);
+
+        // All the bands are split at once, then gated one at a time. Every
+        // band's gate has the same look-ahead so the bands stay in line.
+        crossover.process(samples + start, bandSamples, blockSize);
+
+        for (auto band = 0; band < numBands; band++)
         {
-            auto nonDelayedInput = channelData[i];
-
-            // Get the envelope, in decibels, of the current peak. This is the
-            // non delayed signal and so is ahead of time since we've told the
-            // host we're introducing some latency.
-            auto currentEnvelope = currentPeakFollowers[channel]->processSample(nonDelayedInput);
-            currentEnvelope = juce::Decibels::gainToDecibels(currentEnvelope);
-
-            // Get the delayed input - this is the input N samples ago when we
-            // have N samples of latency (AKA the actual 'live' sample).
-            auto delayedInput = delayLines[channel]->read();
-            delayLines[channel]->write(nonDelayedInput);
-
-            // Get the envelope, in decibels, of the delayed input. This is the
-            // 'live' signal essentially.
-            auto delayedEnvelope = delayedPeakFollowers[channel]->processSample(delayedInput);
-            delayedEnvelope = juce::Decibels::gainToDecibels(delayedEnvelope, -60.f);
-
-            auto previousGain = gates[channel].getCurrentValue();
-
-            // Only modify the gate's state if it's NOT currently in the process
-            // of opening. Otherwise we might start closing the gate before it
-            // fully opening and the peaks won't have full gain.
-            if (gateStates[channel] != GateState::Opening)
-            {
-                // Enter attacking phase (gate opening) if the CURRENT envelope
-                // (ahead of time) is above the threshold.
-                if (currentEnvelope > threshold)
-                {
-                    gateStates[channel] = GateState::Opening;
-                    gates[channel].reset(sampleRate, attack * 0.001);
-                    gates[channel].setCurrentAndTargetValue(previousGain);
-                    gates[channel].setTargetValue(1.f);
-                }
-                // Don't start closing the gate again until the DELAYED envelope
-                // has fallen below the threshold. This allows the gate to fully
-                // open before starting to close again.
-                // Also don't tell the gate to start closing if it's already
-                // in the process of closing because the release time will be
-                // longer than intended.
-                else if (delayedEnvelope < threshold && gateStates[channel] != GateState::Closing)
-                {
-                    gateStates[channel] = GateState::Closing;
-                    gates[channel].reset(sampleRate, release * 0.001);
-                    gates[channel].setCurrentAndTargetValue(previousGain);
-                    gates[channel].setTargetValue(0.f);
-                }
-            }
+            bandGates[static_cast<std::size_t>(band)]->process(bandSamples[band], blockSize, openThreshold,
+                                                               closeThreshold, attack, release, gateCurve,
+                                                               isBypassed);
+        }
+
+        // When bypassed, the gates leave the bands untouched and the input's
+        // left as it is.
+        if (isBypassed)
+            continue;
+
+        juce::FloatVectorOperations::copy(samples + start, bandSamples[0], blockSize);
 
-            // Get the square root of the gate's next value - this means the
-            // slope is more linear when converted to decibels.
-            const auto gain = std::sqrt(gates[channel].getNextValue());
-
-            // Update the gate's state if it's very nearly fully closed or very
-            // nearly fully open. This is to accomodate for any precision loss
-            // where the gain might not be exactly 0 or 1 when the interpolation
-            // finishes.
-            if (gain >= 0.999f && gateStates[channel] == GateState::Opening)
-                gateStates[channel] = GateState::Open;
-            else if (gain < 0.001f && gateStates[channel] == GateState::Closing)
-                gateStates[channel] = GateState::Closed;
-
-            // Apply the gain we've calculated to the delayed input.
-            if (!isBypassed)
-                channelData[i] = gain * delayedInput;
+        for (auto band = 1; band < numBands; band++)
+            juce::FloatVectorOperations::add(samples + start, bandSamples[band], blockSize);
+    }
+}
+
+template <typename Function>
+void GateProcessor::forEachGate(Function&& function)
+{
+    for (auto& bandGates : gateChannels)
+    {
+        for (auto& gateChannel : bandGates)
+        {
+            if (gateChannel != nullptr)
+                function(*gateChannel);
         }
     }
 }
 
+void GateProcessor::updateActivity(juce::Range<float> inputRange, int numSamples)
+{
+    if (numActivitySamples == 0)
+    {
+        currentActivity.inputMinimum = inputRange.getStart();
+        currentActivity.inputMaximum = inputRange.getEnd();
+    }
+    else
+    {
+        currentActivity.inputMinimum = juce::jmin(currentActivity.inputMinimum, inputRange.getStart());
+        currentActivity.inputMaximum = juce::jmax(currentActivity.inputMaximum, inputRange.getEnd());
+    }
+
+    numActivitySamples += numSamples;
+
+    const auto samplesPerSummary = juce::jmax(1, static_cast<int>(getSampleRate()) / activitySummariesPerSecond);
+
+    if (numActivitySamples < samplesPerSummary)
+        return;
+
+    currentActivity.threshold = openThreshold;
+    currentActivity.gain = 0.f;
+
+    for (const auto& bandGates : gateChannels)
+    {
+        for (auto band = 0; band < numBands; band++)
+        {
+            if (const auto& gateChannel = bandGates[static_cast<std::size_t>(band)])
+                currentActivity.gain = juce::jmax(currentActivity.gain, gateChannel->getGain());
+        }
+    }
+
+    // If the editor isn't reading the summaries, the FIFO fills up and new
+    // summaries are simply dropped.
+    activityFifo.push(currentActivity);
+    numActivitySamples = 0;
+}
+
 void GateProcessor::updateDelayLines()
 {
     // Recalculate the latency value which is the number of samples in the
@@ -367,10 +560,61 @@ void GateProcessor::updateDelayLines()
     latency = contrast::round<std::size_t>(attack * getSampleRate() * 0.001f);
 
     // Resize the delay lines to match the latency
-    for (auto& delayLine : delayLines)
+    forEachGate([this](GateChannel& gateChannel) {
+        gateChannel.setDelayLength(latency);
+    });
+}
+
+void GateProcessor::updateThresholds()
+{
+    const auto thresholdGain = juce::Decibels::decibelsToGain(threshold.get(), -100.f);
+    openThreshold = thresholdGain;
+
+    // The lowest threshold is shown as -INF, at which point the gate never
+    // closes once it's been opened.
+    closeThreshold = threshold.get() > threshold.getNormalisableRange().start ? thresholdGain : 0.f;
+}
+
+void GateProcessor::updateKeyFilters()
+{
+    // A frequency of zero turns a filter off.
+    const auto highPassFrequency = keyHighPass.get() > Gate::keyFrequencyMin<float> ? keyHighPass.get() : 0.f;
+    const auto lowPassFrequency = keyLowPass.get() < Gate::keyFrequencyMax<float> ? keyLowPass.get() : 0.f;
+
+    forEachGate([highPassFrequency, lowPassFrequency](GateChannel& gateChannel) {
+        gateChannel.setKeyFilters(highPassFrequency, lowPassFrequency);
+    });
+}
+
+void GateProcessor::updateCrossovers()
+{
+    const auto newNumBands = juce::jlimit(1, Gate::maxBands, bands.get());
+
+    // The gates for any bands that weren't being used are out of date, so
+    // they start again from silence.
+    if (newNumBands > numBands)
+    {
+        for (auto& bandGates : gateChannels)
+        {
+            for (auto band = numBands; band < newNumBands; band++)
+            {
+                if (auto& gateChannel = bandGates[static_cast<std::size_t>(band)])
+                    gateChannel->reset();
+            }
+        }
+    }
+
+    numBands = newNumBands;
+
+    // Only the crossovers between the bands in use are needed, and they must
+    // be in ascending order.
+    std::array<float, Gate::maxBands - 1> frequencies{ crossoverLow.get(), crossoverMid.get(), crossoverHigh.get() };
+    std::sort(frequencies.begin(), frequencies.begin() + (numBands - 1));
+
+    for (auto& crossover : crossovers)
     {
-        if (delayLine != nullptr)
-            delayLine->setLength(latency);
+        if (crossover != nullptr)
+            crossover->setCrossovers(numBands, frequencies.data());
     }
 }
 
@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 
+#include "GateChannel.h"
 #include "../Gate.h"
 
 //======================================================================================================================
@@ -27,6 +28,32 @@ public:
     //==================================================================================================================
     juce::StringArray getPresetNames() const override;
 
+    //==================================================================================================================
+    /** A summary of the gate's activity over a short period, for displaying
+        in the editor.
+    */
+    struct ActivitySummary
+    {
+        // The lowest and highest input samples, across all channels.
+        float inputMinimum = 0.f;
+        float inputMaximum = 0.f;
+
+        // The threshold, as a linear gain.
+        float threshold = 0.f;
+
+        // The highest gain applied by any of the gates, in any band, at the
+        // end of the period.
+        float gain = 0.f;
+    };
+
+    /** The number of activity summaries sent to the editor each second. */
+    static constexpr int activitySummariesPerSecond = 100;
+
+    /** Returns the queue of activity summaries, which should only be read
+        from the message thread.
+    */
+    contrast::LockFreeFifo<ActivitySummary>& getActivityFifo() noexcept;
+
 private:
     //==================================================================================================================
     /** Creates the audio parameters for our plugin which are passed to the
@@ -54,46 +81,96 @@ private:
     /** Updates the length of the delay lines based on the current attack. */
     void updateDelayLines();
 
+    /** Updates the linear thresholds used by the gates from the threshold
+        parameter, which is in decibels.
+    */
+    void updateThresholds();
+
+    /** Updates the gates' key filters from the key filter parameters. */
+    void updateKeyFilters();
+
+    /** Updates the number of bands, and the crossovers between them, from
+        the band parameters.
+    */
+    void updateCrossovers();
+
+    /** Splits one channel into bands, gates each band separately, then sums
+        the bands back together.
+    */
+    void processBands(std::size_t channel, float* samples, int numSamples, const GateCurve& gateCurve,
+                      bool isBypassed);
+
+    /** Calls the given function with the gate for every channel and band. */
+    template <typename Function>
+    void forEachGate(Function&& function);
+
+    /** Adds the given block's input range, and the gates' current gain, to
+        the activity summary, sending it to the editor once it covers long
+        enough.
+    */
+    void updateActivity(juce::Range<float> inputRange, int numSamples);
+
     //==================================================================================================================
     // The parameters are stored in the APVTS so we'll hold references to them
     // so we can access their values easily.
     juce::AudioParameterFloat& threshold;
     juce::AudioParameterFloat& attack;
     juce::AudioParameterFloat& release;
-
-    // Two envelopes to follow the current and delayed peaks. This is so we can
-    // know when to first open the gate (using the current envelope) and then
-    // when to close the gate (using the delayed envelope).
-    // We need one follower for each channel, so they're declared as vectors
-    // (but don't worry, we won't be allocating on the audio thread!).
-    std::vector<std::unique_ptr<contrast::EnvelopeFollower>> currentPeakFollowers;
-    std::vector<std::unique_ptr<contrast::EnvelopeFollower>> delayedPeakFollowers;
-
-    // The actual gates which use a linearly smoothed value to allow the gate
-    // to gradually open and close, instead of instantly stepping from 0 gain to
-    // +1 gain.
-    std::vector<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>> gates;
-
-    // The delay lines that allow us to use a look-ahead technique.
-    std::vector<std::unique_ptr<contrast::DelayLine<float>>> delayLines;
+    juce::AudioParameterChoice& curve;
+    juce::AudioParameterFloat& keyHighPass;
+    juce::AudioParameterFloat& keyLowPass;
+    juce::AudioParameterInt& bands;
+    juce::AudioParameterFloat& crossoverLow;
+    juce::AudioParameterFloat& crossoverMid;
+    juce::AudioParameterFloat& crossoverHigh;
+
+    // The curves that can be selected with the curve parameter, in the same
+    // order as its choices. Their tables are calculated up front so changing
+    // the curve doesn't allocate.
+    const std::array<std::unique_ptr<GateCurve>, 3> curves;
+
+    // The gates for each channel, which each follow their own envelopes and
+    // have their own look-ahead delay line. Each channel has a gate for every
+    // band, though only the first is used when there's a single band.
+    // We need gates for each channel, so they're declared as a vector (but
+    // don't worry, we won't be allocating on the audio thread!).
+    using BandGates = std::array<std::unique_ptr<GateChannel>, Gate::maxBands>;
+    std::vector<BandGates> gateChannels;
+
+    // The crossovers that split each channel into bands, and a buffer to hold
+    // the bands of one channel at a time.
+    std::vector<std::unique_ptr<contrast::LinkwitzRileyCrossover>> crossovers;
+    juce::AudioBuffer<float> bandBuffer;
+
+    // The number of bands currently being gated, which is only used on the
+    // audio thread.
+    int numBands = 1;
 
     // The amount of latency, in samples, that our plugin is introducing to the
     // signal. In the processBlock method we'll need to give this value to the
     // host.
     std::atomic<std::size_t> latency = 0;
 
-    // The gate states help us keep track of which state each of the gates are
-    // in. When the gates are in the process of opening, we don't want them to
-    // be closed again until they've fully opened.
-    enum class GateState
-    {
-        Closed,
-        Opening,
-        Open,
-        Closing
-    };
-
-    std::vector<GateState> gateStates;
+    // The threshold as linear gains, so the gates can compare their envelopes
+    // directly without converting them to decibels. These are only
+    // recalculated when the threshold parameter changes.
+    std::atomic<float> openThreshold{ 0.f };
+    std::atomic<float> closeThreshold{ 0.f };
+
+    // Set when the key filter parameters change, or the gates are recreated,
+    // so the filters' coefficients are only recalculated when needed.
+    std::atomic<bool> keyFiltersChanged{ true };
+
+    // Set when the band parameters change, or the crossovers are recreated.
+    std::atomic<bool> crossoversChanged{ true };
+
+    // The audio thread builds up a summary of the gate's activity over many
+    // samples, then sends it to the editor through the FIFO, so the editor
+    // never needs to look at individual samples. The FIFO holds a few
+    // seconds of summaries in case the editor's slow to read them.
+    contrast::LockFreeFifo<ActivitySummary> activityFifo{ activitySummariesPerSecond * 4 };
+    ActivitySummary currentActivity;
+    int numActivitySamples = 0;
 
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateProcessor)
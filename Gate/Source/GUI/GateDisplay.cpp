@@ -0,0 +1,101 @@
+#include "GateDisplay.h"
+
+//======================================================================================================================
+// The number of summaries shown across the display, and the range of levels
+// shown from bottom to top.
+static constexpr auto historyLength = 300;
+static constexpr auto minimumDecibels = -60.f;
+static constexpr auto refreshRate = 30;
+
+//======================================================================================================================
+GateDisplay::GateDisplay(GateProcessor& p)
+    :   gateProcessor(p),
+        history(static_cast<std::size_t>(historyLength))
+{
+    // Throw away anything that was queued up while the editor was closed so
+    // the display starts from now.
+    auto& fifo = gateProcessor.getActivityFifo();
+    GateProcessor::ActivitySummary summary;
+
+    while (fifo.pop(summary))
+        continue;
+
+    setInterceptsMouseClicks(false, false);
+    startTimerHz(refreshRate);
+}
+
+//======================================================================================================================
+void GateDisplay::paint(juce::Graphics& g)
+{
+    const auto primary = findColour(contrast::LookAndFeel::primaryColourId);
+
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(primary);
+    g.drawRect(bounds, contrast::defaultThickness<float>);
+    bounds.reduce(contrast::defaultThickness<float> * 2.f, contrast::defaultThickness<float> * 2.f);
+
+    // Build the outlines of the input's level and the level the gate let
+    // through, from the oldest summary on the left to the newest on the
+    // right.
+    juce::Path inputPath;
+    juce::Path outputPath;
+    inputPath.startNewSubPath(bounds.getBottomLeft());
+    outputPath.startNewSubPath(bounds.getBottomLeft());
+
+    const auto xStep = bounds.getWidth() / static_cast<float>(historyLength - 1);
+
+    for (std::size_t i = 0; i < history.size(); i++)
+    {
+        const auto& summary = history[(historyWriteIndex + i) % history.size()];
+        const auto peak = juce::jmax(std::abs(summary.inputMinimum), std::abs(summary.inputMaximum));
+        const auto x = bounds.getX() + xStep * static_cast<float>(i);
+
+        inputPath.lineTo(x, getYForLevel(peak, bounds));
+        outputPath.lineTo(x, getYForLevel(peak * summary.gain, bounds));
+    }
+
+    inputPath.lineTo(bounds.getBottomRight());
+    outputPath.lineTo(bounds.getBottomRight());
+    inputPath.closeSubPath();
+    outputPath.closeSubPath();
+
+    // Draw what the gate removed faded out, with what it let through on top.
+    g.setColour(primary.withAlpha(0.25f));
+    g.fillPath(inputPath);
+    g.setColour(primary);
+    g.fillPath(outputPath);
+
+    // Draw the current threshold as a line across the display.
+    const auto& newest = history[(historyWriteIndex + history.size() - 1) % history.size()];
+
+    if (newest.threshold > 0.f)
+    {
+        const auto y = getYForLevel(newest.threshold, bounds);
+        g.setColour(findColour(contrast::LookAndFeel::secondaryColourId));
+        g.drawLine(bounds.getX(), y, bounds.getRight(), y, contrast::defaultThickness<float> + 2.f);
+        g.setColour(primary);
+        g.drawLine(bounds.getX(), y, bounds.getRight(), y, contrast::defaultThickness<float> / 2.f);
+    }
+}
+
+//======================================================================================================================
+void GateDisplay::timerCallback()
+{
+    auto& fifo = gateProcessor.getActivityFifo();
+    auto hasNewSummaries = false;
+
+    while (fifo.pop(history[historyWriteIndex]))
+    {
+        historyWriteIndex = (historyWriteIndex + 1) % history.size();
+        hasNewSummaries = true;
+    }
+
+    if (hasNewSummaries)
+        repaint();
+}
+
+float GateDisplay::getYForLevel(float level, juce::Rectangle<float> bounds)
+{
+    const auto decibels = juce::jmin(juce::Decibels::gainToDecibels(level, minimumDecibels), 0.f);
+    return juce::jmap(decibels, minimumDecibels, 0.f, bounds.getBottom(), bounds.getY());
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../Audio/GateProcessor.h"
+
+//======================================================================================================================
+/** A scrolling display of the gate's recent activity, showing the level of
+    the input, how much of it the gate let through, and the threshold.
+
+    The display only ever reads the summaries the processor sends through its
+    activity FIFO, polling it on a timer and only repainting when there's
+    something new to show.
+*/
+class GateDisplay   :   public juce::Component,
+                        private juce::Timer
+{
+public:
+    //==================================================================================================================
+    explicit GateDisplay(GateProcessor&);
+
+    //==================================================================================================================
+    void paint(juce::Graphics&) override;
+
+private:
+    //==================================================================================================================
+    void timerCallback() override;
+
+    /** Returns the y position of the given linear level within the given
+        bounds.
+    */
+    static float getYForLevel(float level, juce::Rectangle<float> bounds);
+
+    //==================================================================================================================
+    GateProcessor& gateProcessor;
+
+    // The most recent summaries, stored as a ring buffer with the oldest at
+    // the next write index.
+    std::vector<GateProcessor::ActivitySummary> history;
+    std::size_t historyWriteIndex = 0;
+
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateDisplay)
+};
@@ -6,7 +6,8 @@
 GateEditor::GateEditor(GateProcessor& p)
     :   AudioProcessorEditor(&p),
         gateProcessor(p),
-        header(p.getPresetNames(), gateProcessor.getAdditionalProperty(contrast::PropertyIDs::PRESET_INDEX, 0), contrastLaF)
+        header(p.getPresetNames(), gateProcessor.getAdditionalProperty(contrast::PropertyIDs::PRESET_INDEX, 0), contrastLaF),
+        display(p)
 {
     // Initialise our custom LookAndFeel by setting the current colour theme.
     contrastLaF.setUseWhiteAsPrimaryColour(gateProcessor.getAdditionalProperty(
@@ -34,9 +35,25 @@ GateEditor::GateEditor(GateProcessor& p)
                                "Attack",    Gate::ParameterIDs::ATTACK);
     contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), releaseSlider,   releaseAttachment,
                                "Release",   Gate::ParameterIDs::RELEASE);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), curveSlider,     curveAttachment,
+                               "Curve",     Gate::ParameterIDs::CURVE);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), keyHighPassSlider, keyHighPassAttachment,
+                               "Key HPF",   Gate::ParameterIDs::KEY_HIGH_PASS);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), keyLowPassSlider,  keyLowPassAttachment,
+                               "Key LPF",   Gate::ParameterIDs::KEY_LOW_PASS);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), bandsSlider,   bandsAttachment,
+                               "Bands",     Gate::ParameterIDs::BANDS);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), crossoverLowSlider,  crossoverLowAttachment,
+                               "Low X",     Gate::ParameterIDs::CROSSOVER_LOW);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), crossoverMidSlider,  crossoverMidAttachment,
+                               "Mid X",     Gate::ParameterIDs::CROSSOVER_MID);
+    contrast::initialiseSlider(*this, gateProcessor.getAPVTS(), crossoverHighSlider, crossoverHighAttachment,
+                               "High X",    Gate::ParameterIDs::CROSSOVER_HIGH);
+
+    addAndMakeVisible(display);
 
     // Set the size of our UI.
-    setSize(356, 248);
+    setSize(441, 665);
 
     // Tell this Component to use the custom LookAndFeel. All child Components
     // will also use it since this it our top-level component. Also need to
@@ -64,7 +81,15 @@ void GateEditor::resized()
     auto bounds = getLocalBounds();
     header.setBounds(bounds.removeFromTop(35));
 
-    // Use a grid layout for the sliders with 3 columns and 1 row.
+    // The activity display goes along the bottom, inset to line up with the
+    // sliders.
+    display.setBounds(bounds.removeFromBottom(120)
+                            .reduced(contrast::widgetGap<int>, 0)
+                            .withTrimmedBottom(contrast::widgetGap<int>));
+
+    // Use a grid layout for the sliders with 4 columns and 3 rows, with the
+    // key filters and number of bands on the second row, and the crossovers
+    // on the third.
     juce::Grid grid;
     using TI = juce::Grid::TrackInfo;
     using Px = juce::Grid::Px;
@@ -75,9 +100,10 @@ void GateEditor::resized()
         TI(Px(contrast::sliderWidthLarge<int>)),
         TI(Px(0)),
         TI(Px(contrast::sliderWidthSmall<int>)),
+        TI(Px(contrast::sliderWidthSmall<int>)),
         TI(Px(contrast::sliderWidthSmall<int>))
     };
-    grid.templateRows =    { TI(juce::Grid::Fr(1)) };
+    grid.templateRows =    { TI(juce::Grid::Fr(1)), TI(juce::Grid::Fr(1)), TI(juce::Grid::Fr(1)) };
 
     // Make sure the sliders are centered vertically and horizontally
     grid.justifyContent = juce::Grid::JustifyContent::center;
@@ -85,13 +111,14 @@ void GateEditor::resized()
     grid.justifyItems   = juce::Grid::JustifyItems::center;
 
     // Set the gap between the sliders.
-    grid.columnGap = Px(contrast::widgetGap<int>);
+    grid.setGap(Px(contrast::widgetGap<int>));
 
     // Add the sliders to the grid and specify their required sizes.
     grid.items = {
         juce::GridItem(thresholdSlider)
             .withSize(contrast::sliderWidthLarge<float> * 1.2f,
-                      contrast::getRecommendedSliderHeightForWidth(thresholdSlider, contrast::sliderWidthLarge<float>)),
+                      contrast::getRecommendedSliderHeightForWidth(thresholdSlider, contrast::sliderWidthLarge<float>))
+            .withArea(juce::GridItem::Span(2), 1),
 
         juce::GridItem(), // Dummy item with 0 width between threshold and attack
 
@@ -102,6 +129,40 @@ void GateEditor::resized()
         juce::GridItem(releaseSlider)
             .withSize(contrast::sliderWidthSmall<float>,
                       contrast::getRecommendedSliderHeightForWidth(releaseSlider, contrast::sliderWidthSmall<float>)),
+
+        juce::GridItem(curveSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(curveSlider, contrast::sliderWidthSmall<float>)),
+
+        juce::GridItem(keyHighPassSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(keyHighPassSlider, contrast::sliderWidthSmall<float>))
+            .withArea(2, 3),
+
+        juce::GridItem(keyLowPassSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(keyLowPassSlider, contrast::sliderWidthSmall<float>))
+            .withArea(2, 4),
+
+        juce::GridItem(bandsSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(bandsSlider, contrast::sliderWidthSmall<float>))
+            .withArea(2, 5),
+
+        juce::GridItem(crossoverLowSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(crossoverLowSlider, contrast::sliderWidthSmall<float>))
+            .withArea(3, 3),
+
+        juce::GridItem(crossoverMidSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(crossoverMidSlider, contrast::sliderWidthSmall<float>))
+            .withArea(3, 4),
+
+        juce::GridItem(crossoverHighSlider)
+            .withSize(contrast::sliderWidthSmall<float>,
+                      contrast::getRecommendedSliderHeightForWidth(crossoverHighSlider, contrast::sliderWidthSmall<float>))
+            .withArea(3, 5),
     };
 
     // Get the bounds of the actual 'useable' area of the UI.
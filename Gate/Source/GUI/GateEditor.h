@@ -3,6 +3,7 @@
 #include <JuceHeader.h>
 
 #include "../Audio/GateProcessor.h"
+#include "GateDisplay.h"
 
 //======================================================================================================================
 class GateEditor    :   public juce::AudioProcessorEditor
@@ -35,6 +36,30 @@ private:
     juce::Slider releaseSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
 
+    juce::Slider curveSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> curveAttachment;
+
+    juce::Slider keyHighPassSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> keyHighPassAttachment;
+
+    juce::Slider keyLowPassSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> keyLowPassAttachment;
+
+    juce::Slider bandsSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bandsAttachment;
+
+    juce::Slider crossoverLowSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverLowAttachment;
+
+    juce::Slider crossoverMidSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverMidAttachment;
+
+    juce::Slider crossoverHighSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverHighAttachment;
+
+    // Shows what the gate's been doing, below the sliders.
+    GateDisplay display;
+
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateEditor)
 };
@@ -10,6 +10,13 @@ namespace Gate
         constexpr char THRESHOLD[] = "threshold";
         constexpr char ATTACK[]    = "attack";
         constexpr char RELEASE[]   = "release";
+        constexpr char CURVE[]     = "curve";
+        constexpr char KEY_HIGH_PASS[] = "keyHighPass";
+        constexpr char KEY_LOW_PASS[]  = "keyLowPass";
+        constexpr char BANDS[]          = "bands";
+        constexpr char CROSSOVER_LOW[]  = "crossoverLow";
+        constexpr char CROSSOVER_MID[]  = "crossoverMid";
+        constexpr char CROSSOVER_HIGH[] = "crossoverHigh";
     }   // namespace ParameterIDs
 
     //==================================================================================================================
@@ -20,4 +27,17 @@ namespace Gate
 
     template <typename T>
     constexpr T releaseMax = static_cast<T>(2000);
+
+    // The range of the key filters' cutoff frequencies, in Hz. The high-pass
+    // filter is off at the bottom of the range and the low-pass filter is off
+    // at the top.
+    template <typename T>
+    constexpr T keyFrequencyMin = static_cast<T>(20);
+
+    template <typename T>
+    constexpr T keyFrequencyMax = static_cast<T>(20000);
+
+    // The maximum number of bands the signal can be split into, each with its
+    // own gate.
+    constexpr int maxBands = contrast::LinkwitzRileyCrossover::maxBands;
 }   // namespace Gate
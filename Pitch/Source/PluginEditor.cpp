@@ -33,9 +33,36 @@ PluginEditor::PluginEditor(PluginProcessor& p)
                                "Cents", "cents");
     contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(), mixSlider, mixAttachment,
                                "Mix", "mix");
+    contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(), engineSlider, engineAttachment,
+                               "Engine", "engine");
+    contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(), fftSizeSlider, fftSizeAttachment,
+                               "FFT Size", "fftSize");
+    contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(), windowSlider, windowAttachment,
+                               "Window", "window");
+    contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(), voicesSlider, voicesAttachment,
+                               "Voices", "voices");
+
+    for (std::size_t voice = 0; voice < maxVoices; voice++)
+    {
+        const auto voiceNumber = String(voice + 1);
+
+        if (voice > 0)
+        {
+            contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(),
+                                       voiceSemitonesSliders[voice - 1], voiceSemitonesAttachments[voice - 1],
+                                       "Voice " + voiceNumber, "semitones" + voiceNumber);
+        }
+
+        contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(),
+                                   voiceGainSliders[voice], voiceGainAttachments[voice],
+                                   "Gain " + voiceNumber, "gain" + voiceNumber);
+        contrast::initialiseSlider(*this, pitchProcessor.getAPVTS(),
+                                   voicePanSliders[voice], voicePanAttachments[voice],
+                                   "Pan " + voiceNumber, "pan" + voiceNumber);
+    }
 
     // Set the size of the UI.
-    setSize(356, 248);
+    setSize(441, 773);
 }
 
 PluginEditor::~PluginEditor()
@@ -67,8 +94,18 @@ void PluginEditor::resized()
 
     // Use a dummy column with 0 width between the semitones and cents sliders
     // so the gap is twice as wide.
-    grid.templateColumns = { TI(80_px), TI(0_px), TI(65_px), TI(65_px) };
-    grid.templateRows = { TI(1_fr) };
+    grid.templateColumns = { TI(80_px), TI(0_px), TI(65_px), TI(65_px), TI(65_px) };
+    grid.templateRows = { TI(115_px), TI(115_px), TI(115_px), TI(115_px), TI(115_px) };
+
+    // The harmoniser's voices are laid out in columns below the main
+    // controls, with the first voice under the semitones slider.
+    grid.templateAreas = {
+        "semitones gap cents mix .",
+        "semitones gap engine fftSize window",
+        "voices gap semitones2 semitones3 semitones4",
+        "gain1 gap gain2 gain3 gain4",
+        "pan1 gap pan2 pan3 pan4"
+    };
 
     // Make sure the sliders are centered vertically and horixontally
     grid.justifyContent = Grid::JustifyContent::center;
@@ -83,17 +120,53 @@ void PluginEditor::resized()
     // Add the sliders to the grid and specify their required sizes.
     grid.items = {
         GridItem(semitonesSlider)
-            .withSize(90.f, heightForWidth(80.f)),
-
-        GridItem(), // Dummy item with 0 width.
+            .withSize(90.f, heightForWidth(80.f))
+            .withArea("semitones"),
 
         GridItem(centsSlider)
-            .withHeight(heightForWidth(65.f)),
+            .withHeight(heightForWidth(65.f))
+            .withArea("cents"),
 
         GridItem(mixSlider)
             .withHeight(heightForWidth(65.f))
+            .withArea("mix"),
+
+        GridItem(engineSlider)
+            .withHeight(heightForWidth(65.f))
+            .withArea("engine"),
+
+        GridItem(fftSizeSlider)
+            .withHeight(heightForWidth(65.f))
+            .withArea("fftSize"),
+
+        GridItem(windowSlider)
+            .withHeight(heightForWidth(65.f))
+            .withArea("window"),
+
+        GridItem(voicesSlider)
+            .withHeight(heightForWidth(65.f))
+            .withArea("voices")
     };
 
+    for (std::size_t voice = 0; voice < maxVoices; voice++)
+    {
+        const auto voiceNumber = String(voice + 1);
+
+        if (voice > 0)
+        {
+            grid.items.add(GridItem(voiceSemitonesSliders[voice - 1])
+                               .withHeight(heightForWidth(65.f))
+                               .withArea("semitones" + voiceNumber));
+        }
+
+        grid.items.add(GridItem(voiceGainSliders[voice])
+                           .withHeight(heightForWidth(65.f))
+                           .withArea("gain" + voiceNumber));
+        grid.items.add(GridItem(voicePanSliders[voice])
+                           .withHeight(heightForWidth(65.f))
+                           .withArea("pan" + voiceNumber));
+    }
+
     // Get the bounds of the actual 'useable' area of the UI.
     bounds.reduce(contrast::defaultThickness<int>, contrast::defaultThickness<int>);
     bounds.setTop(bounds.getY() - contrast::defaultThickness<int>);
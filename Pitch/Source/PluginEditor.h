@@ -35,6 +35,31 @@ private:
     Slider mixSlider;
     std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
 
+    Slider engineSlider;
+    std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> engineAttachment;
+
+    Slider fftSizeSlider;
+    std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> fftSizeAttachment;
+
+    Slider windowSlider;
+    std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> windowAttachment;
+
+    Slider voicesSlider;
+    std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment> voicesAttachment;
+
+    // The harmoniser's per-voice sliders. The first voice uses the main
+    // semitones slider.
+    static constexpr auto maxVoices = static_cast<std::size_t>(contrast::PitchShifter::maxVoices);
+
+    std::array<Slider, maxVoices - 1> voiceSemitonesSliders;
+    std::array<std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment>, maxVoices - 1> voiceSemitonesAttachments;
+
+    std::array<Slider, maxVoices> voiceGainSliders;
+    std::array<std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment>, maxVoices> voiceGainAttachments;
+
+    std::array<Slider, maxVoices> voicePanSliders;
+    std::array<std::unique_ptr<AudioProcessorValueTreeState::SliderAttachment>, maxVoices> voicePanAttachments;
+
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditor)
 };
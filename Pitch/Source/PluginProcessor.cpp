@@ -6,11 +6,34 @@ PluginProcessor::PluginProcessor()
     :   contrast::PluginProcessor(createParameterLayout(), createDefaultProperties()),
         semitones(*dynamic_cast<AudioParameterInt*>(  getAPVTS().getParameter("semitones"))),
         cents(    *dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("cents"))),
-        mix(      *dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("mix")))
+        mix(      *dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("mix"))),
+        engine(   *dynamic_cast<AudioParameterChoice*>(getAPVTS().getParameter("engine"))),
+        fftSize(  *dynamic_cast<AudioParameterChoice*>(getAPVTS().getParameter("fftSize"))),
+        window(   *dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("window"))),
+        voices(   *dynamic_cast<AudioParameterInt*>(  getAPVTS().getParameter("voices")))
 {
     getAPVTS().addParameterListener("semitones", this);
     getAPVTS().addParameterListener("cents",     this);
     getAPVTS().addParameterListener("mix",       this);
+    getAPVTS().addParameterListener("voices",    this);
+
+    for (auto voice = 0; voice < contrast::PitchShifter::maxVoices; voice++)
+    {
+        const auto voiceIndex = static_cast<std::size_t>(voice);
+        const auto voiceNumber = String(voice + 1);
+
+        if (voice > 0)
+        {
+            voiceSemitones[voiceIndex - 1] = dynamic_cast<AudioParameterInt*>(getAPVTS().getParameter("semitones" + voiceNumber));
+            getAPVTS().addParameterListener("semitones" + voiceNumber, this);
+        }
+
+        voiceGains[voiceIndex] = dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("gain" + voiceNumber));
+        voicePans[voiceIndex]  = dynamic_cast<AudioParameterFloat*>(getAPVTS().getParameter("pan" + voiceNumber));
+
+        getAPVTS().addParameterListener("gain" + voiceNumber, this);
+        getAPVTS().addParameterListener("pan"  + voiceNumber, this);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -18,6 +41,18 @@ PluginProcessor::~PluginProcessor()
     getAPVTS().removeParameterListener("semitones",  this);
     getAPVTS().removeParameterListener("cents",      this);
     getAPVTS().removeParameterListener("mix",        this);
+    getAPVTS().removeParameterListener("voices",     this);
+
+    for (auto voice = 0; voice < contrast::PitchShifter::maxVoices; voice++)
+    {
+        const auto voiceNumber = String(voice + 1);
+
+        if (voice > 0)
+            getAPVTS().removeParameterListener("semitones" + voiceNumber, this);
+
+        getAPVTS().removeParameterListener("gain" + voiceNumber, this);
+        getAPVTS().removeParameterListener("pan"  + voiceNumber, this);
+    }
 }
 
 //======================================================================================================================
@@ -27,18 +62,36 @@ void PluginProcessor::prepareToPlay(double sampleRate, int newBlockSize)
     // channels.
     numChannelsChanged();
 
-    // Initialise the compressors
+    // Initialise the pitch shifters. They're allocated for the longest window
+    // at the current sample rate so the window parameter can be changed
+    // without reallocating.
+    const auto maxWindowLengthSamples = contrast::ceil(maxWindowLength * sampleRate / 1000.0);
+
     for (auto& pitShift : pitShifters)
     {
-        pitShift.reset(new contrast::PitchShifter(5024, sampleRate, static_cast<uint32>(newBlockSize)));
+        pitShift.reset(new contrast::PitchShifter(maxWindowLengthSamples, sampleRate, static_cast<uint32>(newBlockSize)));
         pitShift->setShift(2.f);
         jassert(pitShift);
     }
 
-    // Make sure the compressors are initialised with the current parameters
+    // The spectral engine handles all channels itself.
+    phaseVocoder.reset(new contrast::PhaseVocoder(static_cast<int>(pitShifters.size()),
+                                                  contrast::PhaseVocoder::minFFTOrder + fftSize.getIndex()));
+
+    // The low-latency engines are allocated for the longest window so the
+    // window parameter can be changed without reallocating.
+    for (auto& wsolaShifter : wsolaShifters)
+    {
+        wsolaShifter.reset(new contrast::WsolaPitchShifter(sampleRate, maxWindowLength, newBlockSize));
+        jassert(wsolaShifter);
+    }
+
+    // Make sure the pitch shifters are initialised with the current parameters
     // by faking some parameter changed calls.
     parameterChanged("semitones",   static_cast<float>(semitones.get()));
     parameterChanged("cents",       cents);
+    parameterChanged("mix",         mix);
+    updateVoices();
 }
 
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
@@ -49,15 +102,47 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiB
     const auto numSamples = static_cast<std::size_t>(buffer.getNumSamples());
 
     jassert(pitShifters.size() == numChannels);
+    jassert(phaseVocoder);
+    jassert(wsolaShifters.size() == numChannels);
+
+    if (static_cast<Engine>(engine.getIndex()) == Engine::Spectral)
+    {
+        // The FFT size is applied here, rather than when the parameter
+        // changes, so it can't change part way through a block. This won't
+        // allocate as the PhaseVocoder preallocates for every size.
+        phaseVocoder->setFFTOrder(contrast::PhaseVocoder::minFFTOrder + fftSize.getIndex());
+        phaseVocoder->process(buffer.getArrayOfWritePointers(), static_cast<int>(numChannels), static_cast<int>(numSamples));
+
+        setLatencySamples(phaseVocoder->getLatency());
+        return;
+    }
+
+    if (static_cast<Engine>(engine.getIndex()) == Engine::LowLatency)
+    {
+        for (std::size_t channel = 0; channel < numChannels; channel++)
+        {
+            jassert(wsolaShifters[channel]);
+
+            // As with the FFT size, the window is applied here so it can't
+            // change part way through a block.
+            wsolaShifters[channel]->setWindowLength(window);
+            wsolaShifters[channel]->process(buffer.getWritePointer(static_cast<int>(channel)),
+                                            static_cast<int>(numSamples));
+        }
+
+        setLatencySamples(wsolaShifters[0]->getLatency());
+        return;
+    }
+
+    const auto windowLengthSamples = juce::roundToInt(window * getSampleRate() / 1000.0);
 
     for (std::size_t channel = 0; channel < numChannels; channel++)
     {
         jassert(pitShifters[channel]);
 
-        auto channelData = buffer.getWritePointer(static_cast<int>(channel));
-
-        for (std::size_t i = 0; i < numSamples; i++)
-            channelData[i] = pitShifters[channel]->processSample(channelData[i]);
+        pitShifters[channel]->setWindowLength(windowLengthSamples);
+        pitShifters[channel]->process(buffer.getWritePointer(static_cast<int>(channel)),
+                                      static_cast<int>(numSamples));
     }
 
     setLatencySamples(pitShifters[0]->getDelayLength() / 2);
@@ -70,6 +155,8 @@ void PluginProcessor::processBlockBypassed(juce::AudioBuffer<float>&, juce::Midi
 void PluginProcessor::releaseResources()
 {
     pitShifters.clear();
+    phaseVocoder.reset();
+    wsolaShifters.clear();
 }
 
 void PluginProcessor::numChannelsChanged()
@@ -81,6 +168,7 @@ void PluginProcessor::numChannelsChanged()
                                                                  getTotalNumOutputChannels()));
 
     pitShifters.resize(numChannels);
+    wsolaShifters.resize(numChannels);
 }
 
 //======================================================================================================================
@@ -96,12 +184,14 @@ void PluginProcessor::presetChoiceChanged(int presetIndex)
     auto newSemitones = static_cast<int>(semitones);
     auto newCents     = static_cast<float>(cents);
     auto newMix       = static_cast<float>(mix);
+    auto newVoices    = static_cast<int>(voices);
 
     if (presetIndex == 0)
     {
         newSemitones = 0;
         newCents = 0;
         newMix = 1.f;
+        newVoices = 1;
     }
 
     semitones.beginChangeGesture();
@@ -115,6 +205,10 @@ void PluginProcessor::presetChoiceChanged(int presetIndex)
     mix.beginChangeGesture();
     mix = newMix;
     mix.endChangeGesture();
+
+    voices.beginChangeGesture();
+    voices = newVoices;
+    voices.endChangeGesture();
 }
 
 //======================================================================================================================
@@ -122,10 +216,16 @@ void PluginProcessor::parameterChanged(const String& parameterID, float)
 {
     if (parameterID == "semitones" || parameterID == "cents")
     {
-        for (auto& pitShift : pitShifters)
+        // The cents parameter fine-tunes every voice of the harmoniser.
+        updateVoices();
+
+        if (phaseVocoder != nullptr)
+            phaseVocoder->setShift(semitones, cents);
+
+        for (auto& wsolaShifter : wsolaShifters)
         {
-            jassert(pitShift);
-            pitShift->setShift(semitones, cents);
+            if (wsolaShifter != nullptr)
+                wsolaShifter->setShift(semitones, cents);
         }
     }
     else if (parameterID == "mix")
@@ -135,6 +235,56 @@ void PluginProcessor::parameterChanged(const String& parameterID, float)
             jassert(pitShift);
             pitShift->setMix(mix);
         }
+
+        if (phaseVocoder != nullptr)
+            phaseVocoder->setMix(mix);
+
+        for (auto& wsolaShifter : wsolaShifters)
+        {
+            if (wsolaShifter != nullptr)
+                wsolaShifter->setMix(mix);
+        }
+    }
+    else if (parameterID == "voices"
+             || parameterID.startsWith("semitones")
+             || parameterID.startsWith("gain")
+             || parameterID.startsWith("pan"))
+    {
+        updateVoices();
+    }
+}
+
+void PluginProcessor::updateVoices()
+{
+    const auto numChannels = pitShifters.size();
+
+    for (std::size_t channel = 0; channel < numChannels; channel++)
+    {
+        auto& pitShift = pitShifters[channel];
+
+        if (pitShift == nullptr)
+            continue;
+
+        pitShift->setNumVoices(voices);
+
+        for (std::size_t voice = 0; voice < static_cast<std::size_t>(contrast::PitchShifter::maxVoices); voice++)
+        {
+            const auto voiceSemitonesValue = voice == 0 ? semitones.get() : voiceSemitones[voice - 1]->get();
+            pitShift->setVoiceShift(static_cast<int>(voice), voiceSemitonesValue, cents);
+
+            // Pan using a balance law so a centred voice is at its full gain.
+            // Panning only applies to stereo layouts.
+            auto panGain = 1.f;
+
+            if (numChannels == 2)
+            {
+                const auto pan = voicePans[voice]->get();
+                panGain = channel == 0 ? juce::jmin(1.f, 1.f - pan) : juce::jmin(1.f, 1.f + pan);
+            }
+
+            const auto gain = Decibels::decibelsToGain(voiceGains[voice]->get(), minVoiceGain);
+            pitShift->setVoiceGain(static_cast<int>(voice), gain * panGain);
+        }
     }
 }
 
@@ -188,14 +338,134 @@ AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLa
                 return text.getFloatValue() / 100.f;
             }));
 
+    // The classic engine is the STK-derived delay-line algorithm, which has
+    // the lowest CPU cost. The spectral engine is a phase vocoder which
+    // handles large shifts better at the cost of more CPU and latency. The
+    // low-latency engine splices the signal at points found by correlation so
+    // its latency is set by the window parameter.
+    auto engineParam = std::make_unique<AudioParameterChoice>(
+        juce::ParameterID{
+            "engine",
+            1,
+        },
+        "Engine",
+        StringArray{ "Classic", "Spectral", "Low Latency" },
+        0);
+
+    // The FFT size used by the spectral engine. Larger sizes give better
+    // quality for tonal material but add more latency.
+    auto fftSizeParam = std::make_unique<AudioParameterChoice>(
+        juce::ParameterID{
+            "fftSize",
+            1,
+        },
+        "FFT Size",
+        StringArray{ "512", "1024", "2048", "4096" },
+        2);
+
+    // The window length used by the classic and low-latency engines, in
+    // milliseconds. The latency is roughly half the window.
+    auto windowParam = std::make_unique<AudioParameterFloat>(
+        juce::ParameterID{
+            "window",
+            1,
+        },
+        "Window",
+        NormalisableRange<float>(3.f, maxWindowLength, 0.f, 0.4f),
+        50.f,
+        juce::AudioParameterFloatAttributes{}
+            .withStringFromValueFunction([](float value, int) -> String {
+                return contrast::pretifyValue(value, 3) + "ms";
+            })
+            .withValueFromStringFunction([](const String& text) -> float {
+                return text.getFloatValue();
+            }));
+
+    // The number of voices produced by the classic engine. Each voice has its
+    // own interval, gain and pan, with the first voice using the semitones
+    // parameter.
+    auto voicesParam = std::make_unique<AudioParameterInt>(
+        juce::ParameterID{
+            "voices",
+            1,
+        },
+        "Voices",
+        1, contrast::PitchShifter::maxVoices, 1);
+
     // In this plugin we only have one, unnamed group that all of our parameters
     // we live in.
     std::vector<std::unique_ptr<AudioProcessorParameterGroup>> groups;
     groups.push_back(std::make_unique<AudioProcessorParameterGroup>(
         "pitch", "Pitch", "",
-        std::move(semitonesParam), std::move(centsParam), std::move(mixParam)
+        std::move(semitonesParam), std::move(centsParam), std::move(mixParam),
+        std::move(engineParam), std::move(fftSizeParam), std::move(windowParam),
+        std::move(voicesParam)
     ));
 
+    // The harmoniser's per-voice parameters live in their own group.
+    auto voicesGroup = std::make_unique<AudioProcessorParameterGroup>("voices", "Voices", "");
+    const std::array<int, contrast::PitchShifter::maxVoices - 1> defaultVoiceSemitones{ 4, 7, 12 };
+
+    for (auto voice = 0; voice < contrast::PitchShifter::maxVoices; voice++)
+    {
+        const auto voiceNumber = String(voice + 1);
+
+        if (voice > 0)
+        {
+            voicesGroup->addChild(std::make_unique<AudioParameterInt>(
+                juce::ParameterID{
+                    "semitones" + voiceNumber,
+                    1,
+                },
+                "Semitones " + voiceNumber,
+                -24, 24, defaultVoiceSemitones[static_cast<std::size_t>(voice - 1)],
+                juce::AudioParameterIntAttributes{}
+                    .withStringFromValueFunction([](int value, int) -> String {
+                        return String(value);
+                    })
+                    .withValueFromStringFunction([](const String& text) -> int {
+                        return text.getIntValue();
+                    })));
+        }
+
+        voicesGroup->addChild(std::make_unique<AudioParameterFloat>(
+            juce::ParameterID{
+                "gain" + voiceNumber,
+                1,
+            },
+            "Gain " + voiceNumber,
+            NormalisableRange<float>(minVoiceGain, 6.f),
+            0.f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float value, int) -> String {
+                    if (value <= minVoiceGain)
+                        return "-inf";
+
+                    return contrast::pretifyValue(value, 3) + "dB";
+                })
+                .withValueFromStringFunction([](const String& text) -> float {
+                    return text.getFloatValue();
+                })));
+
+        voicesGroup->addChild(std::make_unique<AudioParameterFloat>(
+            juce::ParameterID{
+                "pan" + voiceNumber,
+                1,
+            },
+            "Pan " + voiceNumber,
+            NormalisableRange<float>(-1.f, 1.f),
+            0.f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float value, int) -> String {
+                    return contrast::pretifyValue(value * 100.f, 3);
+                })
+                .withValueFromStringFunction([](const String& text) -> float {
+                    return text.getFloatValue() / 100.f;
+                })));
+    }
+
+    groups.push_back(std::move(voicesGroup));
+
     return { groups.begin(), groups.end() };
 }
 
@@ -39,14 +39,54 @@ private:
     void parameterChanged(const String&, float) override;
     void presetChoiceChanged(int newPresetIndex) override;
 
+    /** Applies the harmoniser's voice parameters to the classic pitch
+        shifters.
+    */
+    void updateVoices();
+
     //==================================================================================================================
-    // Need a Compressor object for each channel.
+    // The pitch-shifting algorithms that can be selected with the engine
+    // parameter.
+    enum class Engine
+    {
+        Classic,
+        Spectral,
+        LowLatency
+    };
+
+    // The longest window the classic and low-latency engines can use, in
+    // milliseconds.
+    static constexpr float maxWindowLength = 120.f;
+
+    // The lowest gain of a harmoniser voice, in decibels, below which the
+    // voice is silent.
+    static constexpr float minVoiceGain = -60.f;
+
+    //==================================================================================================================
+    // Need a PitchShifter object for each channel.
     std::vector<std::unique_ptr<contrast::PitchShifter>> pitShifters;
 
+    // The spectral engine processes every channel with a single object so the
+    // channels can share its FFTs and scratch buffers.
+    std::unique_ptr<contrast::PhaseVocoder> phaseVocoder;
+
+    // The low-latency engine needs an object for each channel.
+    std::vector<std::unique_ptr<contrast::WsolaPitchShifter>> wsolaShifters;
+
     // Parameter references for easy access.
     AudioParameterInt& semitones;
     AudioParameterFloat& cents;
     AudioParameterFloat& mix;
+    AudioParameterChoice& engine;
+    AudioParameterChoice& fftSize;
+    AudioParameterFloat& window;
+    AudioParameterInt& voices;
+
+    // The first voice uses the semitones parameter, so there are only
+    // semitone parameters for the additional voices.
+    std::array<AudioParameterInt*, contrast::PitchShifter::maxVoices - 1> voiceSemitones;
+    std::array<AudioParameterFloat*, contrast::PitchShifter::maxVoices> voiceGains;
+    std::array<AudioParameterFloat*, contrast::PitchShifter::maxVoices> voicePans;
 
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
@@ -0,0 +1,140 @@
+#include "MultibandCompressor.h"
+
+//======================================================================================================================
+MultibandCompressor::MultibandCompressor(double sampleRate, int maximumBlockSize)
+    :   samplesPerMS(static_cast<float>(sampleRate) / 1000.f),
+        crossover(sampleRate, maximumBlockSize),
+        gainComputer(static_cast<float>(sampleRate)),
+        bands(static_cast<std::size_t>(juce::jmax(1, maximumBlockSize)))
+{
+}
+
+//======================================================================================================================
+void MultibandCompressor::setCrossovers(int numBands, const float* frequencies)
+{
+    // The envelopes of bands that weren't being used are out of date.
+    if (numBands != crossover.getNumBands())
+        envelope = Register(0.f);
+
+    crossover.setCrossovers(numBands, frequencies);
+
+    for (auto band = 0; band < contrast::LinkwitzRileyCrossover::maxBands; band++)
+        bandsInUse.set(static_cast<std::size_t>(band), band < numBands ? 1.f : 0.f);
+}
+
+void MultibandCompressor::setParameters(float threshold, float ratio, float knee, float attackInMS,
+                                        float releaseInMS, float makeupGainDB)
+{
+    gainComputer.setThreshold(threshold);
+    gainComputer.setRatio(ratio);
+    gainComputer.setKnee(knee);
+    gainComputer.setMakeupGain(makeupGainDB);
+
+    attackCoefficient = Register(contrast::EnvelopeFollower::calculateCoefficient(attackInMS, samplesPerMS));
+    releaseCoefficient = Register(contrast::EnvelopeFollower::calculateCoefficient(releaseInMS, samplesPerMS));
+
+    kneeStart = juce::Decibels::decibelsToGain(threshold - knee / 2.f, -1000.f);
+    makeupGain = juce::Decibels::decibelsToGain(makeupGainDB);
+}
+
+//======================================================================================================================
+void MultibandCompressor::process(float* samples, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const auto maxBlockSize = static_cast<int>(bands.size());
+    auto minimumGain = 1.f;
+    auto gainSum = 0.f;
+
+    for (auto start = 0; start < numSamples; start += maxBlockSize)
+        processBlock(samples + start, juce::jmin(maxBlockSize, numSamples - start), minimumGain, gainSum);
+
+    gainReduction = contrast::Compressor::makeGainReduction(minimumGain, gainSum / static_cast<float>(numSamples));
+}
+
+contrast::Compressor::GainReduction MultibandCompressor::getGainReduction() const noexcept
+{
+    return gainReduction;
+}
+
+void MultibandCompressor::processBlock(float* samples, int numSamples, float& minimumGain, float& gainSum)
+{
+    crossover.process(samples, bands.data(), numSamples);
+
+    // Work on local copies so the compiler can keep them in registers for the
+    // whole block.
+    auto currentEnvelope = envelope;
+    const auto attack = attackCoefficient;
+    const auto release = releaseCoefficient;
+
+    // With neutral settings every band's gain is one so there's no need to
+    // work out the gains. The bands are still split and summed, and their
+    // envelopes followed, so nothing jumps when the settings change.
+    if (gainComputer.isNeutral())
+    {
+        const auto gains = bandsInUse;
+
+        for (auto i = 0; i < numSamples; i++)
+        {
+            const auto band = bands[static_cast<std::size_t>(i)];
+            currentEnvelope = followEnvelope(currentEnvelope, band, attack, release);
+            samples[i] = (band * gains).sum();
+        }
+
+        envelope = currentEnvelope;
+        gainSum += static_cast<float>(numSamples);
+        return;
+    }
+
+    const auto numBands = static_cast<std::size_t>(crossover.getNumBands());
+
+    for (auto i = 0; i < numSamples; i++)
+    {
+        const auto band = bands[static_cast<std::size_t>(i)];
+        currentEnvelope = followEnvelope(currentEnvelope, band, attack, release);
+
+        // Any lanes beyond the number of bands are left with a gain of zero
+        // so they don't add to the sum.
+        auto gains = Register(0.f);
+        auto lowestGain = 1.f;
+
+        for (std::size_t lane = 0; lane < numBands; lane++)
+        {
+            const auto bandEnvelope = currentEnvelope.get(lane);
+
+            if (bandEnvelope <= kneeStart)
+            {
+                gains.set(lane, 1.f);
+                continue;
+            }
+
+            // Like the single band Compressor, the makeup gain is only
+            // applied above the knee, so quiet material is left at the
+            // same level whichever mode is used.
+            const auto gain = gainComputer.calculateGain(juce::Decibels::gainToDecibels(bandEnvelope));
+            gains.set(lane, gain * makeupGain);
+            lowestGain = juce::jmin(lowestGain, gain);
+        }
+
+        samples[i] = (band * gains).sum();
+
+        minimumGain = juce::jmin(minimumGain, lowestGain);
+        gainSum += lowestGain;
+    }
+
+    envelope = currentEnvelope;
+}
+
+MultibandCompressor::Register MultibandCompressor::followEnvelope(Register currentEnvelope, Register band,
+                                                                  Register attack, Register release)
+{
+    const auto level = Register::abs(band);
+
+    // Use the attack where the band is louder than its envelope and the
+    // release everywhere else.
+    const auto isRising = Register::greaterThan(level, currentEnvelope);
+    const auto coefficient = (attack & isRising) + (release & ~isRising);
+
+    return coefficient * (currentEnvelope - level) + level;
+}
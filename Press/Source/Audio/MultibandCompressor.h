@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//======================================================================================================================
+/** Compresses a single channel of audio split into up to four bands, with
+    each band compressed separately before they're summed back together.
+
+    The bands are kept in the lanes of a juce::dsp::SIMDRegister from the
+    crossover all the way to the final sum, so the filters and the envelope
+    followers for every band run at once. Only the conversion of each band's
+    envelope to a gain is done one band at a time, using a contrast::Compressor
+    as the gain computer, and even that's skipped for any band below the knee.
+*/
+class MultibandCompressor
+{
+public:
+    //==================================================================================================================
+    MultibandCompressor(double sampleRate, int maximumBlockSize);
+
+    //==================================================================================================================
+    /** Sets the number of bands and the frequencies they're split at. There
+        must be one less frequency than there are bands, in ascending order.
+    */
+    void setCrossovers(int numBands, const float* frequencies);
+
+    /** Sets the compression applied to every band. The threshold, knee and
+        makeup gain are in decibels, and the times in milliseconds.
+    */
+    void setParameters(float threshold, float ratio, float knee, float attackInMS, float releaseInMS,
+                       float makeupGainDB);
+
+    //==================================================================================================================
+    /** Compresses the given samples in place. */
+    void process(float* samples, int numSamples);
+
+    /** Returns the gain reduction applied by the last call to process(),
+        taking the most reduced band at each sample.
+    */
+    contrast::Compressor::GainReduction getGainReduction() const noexcept;
+
+private:
+    //==================================================================================================================
+    using Register = contrast::LinkwitzRileyCrossover::Register;
+
+    /** Compresses a block no longer than the maximum block size, adding
+        the lowest gain at each sample to the given sum.
+    */
+    void processBlock(float* samples, int numSamples, float& minimumGain, float& gainSum);
+
+    /** Returns the envelopes of every band after following the given
+        samples of each band.
+    */
+    static Register followEnvelope(Register currentEnvelope, Register band, Register attack, Register release);
+
+    //==================================================================================================================
+    const float samplesPerMS;
+
+    contrast::LinkwitzRileyCrossover crossover;
+
+    // Only used to calculate the gain for each band's envelope. All the bands
+    // share its settings.
+    contrast::Compressor gainComputer;
+
+    // The envelopes of all the bands, and the coefficients used to follow
+    // them.
+    Register envelope{ 0.f };
+    Register attackCoefficient{ 0.f };
+    Register releaseCoefficient{ 0.f };
+
+    // A gain of one for each band in use, and zero for the other lanes.
+    Register bandsInUse{ 0.f };
+
+    // The level, as a linear gain, below which a band's left untouched, so
+    // quiet bands don't need converting to decibels.
+    float kneeStart = 1.f;
+    float makeupGain = 1.f;
+
+    contrast::Compressor::GainReduction gainReduction;
+
+    // Scratch space for the bands of each block.
+    std::vector<Register> bands;
+
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultibandCompressor)
+};
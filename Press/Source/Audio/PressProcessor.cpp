@@ -11,16 +11,40 @@ PressProcessor::PressProcessor()
         knee     (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::KNEE))),
         attack   (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::ATTACK))),
         release  (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::RELEASE))),
-        gain     (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::GAIN)))
+        gain     (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::GAIN))),
+        bands    (*dynamic_cast<juce::AudioParameterInt*>(getAPVTS().getParameter(Press::ParameterIDs::BANDS))),
+        crossoverLow (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::CROSSOVER_LOW))),
+        crossoverMid (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::CROSSOVER_MID))),
+        crossoverHigh(*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Press::ParameterIDs::CROSSOVER_HIGH)))
 {
+    getAPVTS().addParameterListener(Press::ParameterIDs::THRESHOLD,      this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::RATIO,          this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::KNEE,           this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::ATTACK,         this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::RELEASE,        this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::GAIN,           this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::BANDS,          this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::CROSSOVER_LOW,  this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::CROSSOVER_MID,  this);
+    getAPVTS().addParameterListener(Press::ParameterIDs::CROSSOVER_HIGH, this);
 }
 
 PressProcessor::~PressProcessor()
 {
+    getAPVTS().removeParameterListener(Press::ParameterIDs::THRESHOLD,      this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::RATIO,          this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::KNEE,           this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::ATTACK,         this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::RELEASE,        this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::GAIN,           this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::BANDS,          this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::CROSSOVER_LOW,  this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::CROSSOVER_MID,  this);
+    getAPVTS().removeParameterListener(Press::ParameterIDs::CROSSOVER_HIGH, this);
 }
 
 //======================================================================================================================
-void PressProcessor::prepareToPlay(double sampleRate, int /* blockSize */)
+void PressProcessor::prepareToPlay(double sampleRate, int blockSize)
 {
     // Make sure the vectors have been resized to fit the current number of
     // channels.
@@ -30,6 +54,11 @@ void PressProcessor::prepareToPlay(double sampleRate, int /* blockSize */)
     for (auto& compressor : compressors)
         compressor.reset(new contrast::Compressor(static_cast<float>(sampleRate)));
 
+    for (auto& multibandCompressor : multibandCompressors)
+        multibandCompressor.reset(new MultibandCompressor(sampleRate, blockSize));
+
+    // The compressors have all been recreated so need the current parameters.
+    parametersChanged = false;
     updateCompressors();
 }
 
@@ -37,28 +66,45 @@ void PressProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
 {
     juce::ScopedNoDenormals noDenormals;
 
-    // Make sure the compressors are up-to-date.
-    updateCompressors();
+    // Only update the compressors when the parameters have actually changed,
+    // since that recalculates the envelope coefficients of every band.
+    if (parametersChanged.exchange(false))
+        updateCompressors();
 
     const auto numChannels = static_cast<std::size_t>(buffer.getNumChannels());
-    const auto numSamples = static_cast<std::size_t>(buffer.getNumSamples());
+    const auto numSamples = buffer.getNumSamples();
 
     jassert(compressors.size() >= numChannels);
+    jassert(multibandCompressors.size() >= numChannels);
+
+    // In multiband mode, every band of a channel is compressed at once.
+    if (bands.get() > 1)
+    {
+        for (std::size_t channel = 0; channel < numChannels; channel++)
+        {
+            jassert(multibandCompressors[channel] != nullptr);
+
+            multibandCompressors[channel]->process(buffer.getWritePointer(static_cast<int>(channel)), numSamples);
+        }
+
+        sendGainReduction(numChannels, true);
+        return;
+    }
 
     for (std::size_t channel = 0; channel < numChannels; channel++)
     {
         jassert(compressors[channel] != nullptr);
 
-        auto channelData = buffer.getWritePointer(static_cast<int>(channel));
-
-        for (std::size_t i = 0; i < numSamples; i++)
-            channelData[i] = compressors[channel]->processSample(channelData[i]);
+        compressors[channel]->process(buffer.getWritePointer(static_cast<int>(channel)), numSamples);
     }
+
+    sendGainReduction(numChannels, false);
 }
 
 void PressProcessor::releaseResources()
 {
     compressors.clear();
+    multibandCompressors.clear();
 }
 
 void PressProcessor::numChannelsChanged()
@@ -69,6 +115,29 @@ void PressProcessor::numChannelsChanged()
     const auto numChannels = static_cast<std::size_t>(juce::jmax(getTotalNumInputChannels(),
                                                                  getTotalNumOutputChannels()));
     compressors.resize(numChannels);
+    multibandCompressors.resize(numChannels);
+}
+
+//======================================================================================================================
+PressProcessor::GainReductionFifo& PressProcessor::getGainReductionFifo() noexcept
+{
+    return gainReductionFifo;
+}
+
+void PressProcessor::sendGainReduction(std::size_t numChannels, bool isMultiband)
+{
+    contrast::Compressor::GainReduction gainReduction;
+
+    for (std::size_t channel = 0; channel < numChannels; channel++)
+    {
+        const auto channelGainReduction = isMultiband ? multibandCompressors[channel]->getGainReduction()
+                                                      : compressors[channel]->getGainReduction();
+
+        gainReduction.peak = juce::jmax(gainReduction.peak, channelGainReduction.peak);
+        gainReduction.average = juce::jmax(gainReduction.average, channelGainReduction.average);
+    }
+
+    gainReductionFifo.push(gainReduction);
 }
 
 //======================================================================================================================
@@ -203,13 +272,63 @@ juce::AudioProcessorValueTreeState::ParameterLayout PressProcessor::createParame
                 return text.getFloatValue();
             }));
 
+    // The signal can be split into several bands which are each compressed
+    // separately, so, for example, a loud bass note doesn't duck the cymbals
+    // above it.
+    auto bandsParam = std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{
+            Press::ParameterIDs::BANDS,
+            1,
+        },
+        "Bands",
+        1,
+        Press::maxBands,
+        1);
+
+    // The frequencies the bands are split at. The crossovers are kept in
+    // order when they're used, so they can be set freely.
+    auto crossoverRange = juce::NormalisableRange<float>(20.f, 20000.f);
+    crossoverRange.setSkewForCentre(1000.f);
+
+    auto createCrossoverParam = [&crossoverRange](const char* parameterID, const juce::String& name,
+                                                  float defaultValue) {
+        return std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{
+                parameterID,
+                1,
+            },
+            name,
+            crossoverRange,
+            defaultValue,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float value, int) -> juce::String {
+                    if (value < 1000.f)
+                        return contrast::pretifyValue(value, 3) + "Hz";
+
+                    // Display as kHz if the value is over 1000 Hz
+                    return contrast::pretifyValue(value / 1000.f, 3) + "kHz";
+                })
+                .withValueFromStringFunction([](const juce::String& text) -> float {
+                    if (text.endsWithIgnoreCase("kHz"))
+                        return text.getFloatValue() * 1000.f;
+
+                    return text.getFloatValue();
+                }));
+    };
+
+    auto crossoverLowParam  = createCrossoverParam(Press::ParameterIDs::CROSSOVER_LOW,  "Low X-Over",  150.f);
+    auto crossoverMidParam  = createCrossoverParam(Press::ParameterIDs::CROSSOVER_MID,  "Mid X-Over",  1500.f);
+    auto crossoverHighParam = createCrossoverParam(Press::ParameterIDs::CROSSOVER_HIGH, "High X-Over", 6000.f);
+
     // In this plugin we only have one, unnamed group that all of our parameters
     // we live in.
     std::vector<std::unique_ptr<juce::AudioProcessorParameterGroup>> groups;
     groups.push_back(std::make_unique<juce::AudioProcessorParameterGroup>(
         "press", "Press", "",
         std::move(thresholdParam), std::move(ratioParam), std::move(kneeParam),
-        std::move(attackParam), std::move(releaseParam), std::move(gainParam)
+        std::move(attackParam), std::move(releaseParam), std::move(gainParam),
+        std::move(bandsParam), std::move(crossoverLowParam), std::move(crossoverMidParam),
+        std::move(crossoverHighParam)
     ));
 
     return { groups.begin(), groups.end() };
@@ -296,6 +415,11 @@ void PressProcessor::presetChoiceChanged(int presetIndex)
     gain.endChangeGesture();
 }
 
+void PressProcessor::parameterChanged(const juce::String&, float)
+{
+    parametersChanged = true;
+}
+
 void PressProcessor::updateCompressors()
 {
     for (auto& compressor : compressors)
@@ -309,6 +433,21 @@ void PressProcessor::updateCompressors()
         compressor->setRelease   (release);
         compressor->setMakeupGain(gain);
     }
+
+    // Only the crossovers between the bands in use are needed, and they must
+    // be in ascending order.
+    const auto numBands = juce::jlimit(1, Press::maxBands, bands.get());
+
+    std::array<float, Press::maxBands - 1> frequencies{ crossoverLow.get(), crossoverMid.get(), crossoverHigh.get() };
+    std::sort(frequencies.begin(), frequencies.begin() + (numBands - 1));
+
+    for (auto& multibandCompressor : multibandCompressors)
+    {
+        jassert(multibandCompressor != nullptr);
+
+        multibandCompressor->setCrossovers(numBands, frequencies.data());
+        multibandCompressor->setParameters(threshold, ratio, knee, attack, release, gain);
+    }
 }
 
 //======================================================================================================================
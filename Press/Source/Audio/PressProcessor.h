@@ -2,8 +2,11 @@
 
 #include <JuceHeader.h>
 
+#include "MultibandCompressor.h"
+
 //======================================================================================================================
-class PressProcessor    :   public contrast::PluginProcessor
+class PressProcessor    :   public contrast::PluginProcessor,
+                            private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==================================================================================================================
@@ -24,18 +27,36 @@ public:
     //==================================================================================================================
     juce::StringArray getPresetNames() const override;
 
+    //==================================================================================================================
+    using GainReductionFifo = contrast::LockFreeFifo<contrast::Compressor::GainReduction>;
+
+    /** Returns the queue of the gain reduction applied to each block, which
+        should only be read from the message thread.
+    */
+    GainReductionFifo& getGainReductionFifo() noexcept;
+
 private:
     //==================================================================================================================
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout() const override;
     juce::ValueTree createDefaultProperties() const override;
     void presetChoiceChanged(int) override;
+    void parameterChanged(const juce::String&, float) override;
 
     void updateCompressors();
 
+    /** Sends the most gain reduction applied to any channel in the last block
+        to the editor.
+    */
+    void sendGainReduction(std::size_t numChannels, bool isMultiband);
+
     //==================================================================================================================
     // Need a Compressor object for each channel.
     std::vector<std::unique_ptr<contrast::Compressor>> compressors;
 
+    // And a MultibandCompressor for each channel, used instead of the
+    // Compressors when there's more than one band.
+    std::vector<std::unique_ptr<MultibandCompressor>> multibandCompressors;
+
     // Parameter references for easy access.
     juce::AudioParameterFloat& threshold;
     juce::AudioParameterFloat& ratio;
@@ -43,6 +64,19 @@ private:
     juce::AudioParameterFloat& attack;
     juce::AudioParameterFloat& release;
     juce::AudioParameterFloat& gain;
+    juce::AudioParameterInt& bands;
+    juce::AudioParameterFloat& crossoverLow;
+    juce::AudioParameterFloat& crossoverMid;
+    juce::AudioParameterFloat& crossoverHigh;
+
+    // Set whenever one of the compressors' parameters changes, so they're
+    // only updated when they need to be.
+    std::atomic<bool> parametersChanged{ true };
+
+    // The audio thread pushes a summary of the gain reduction for each block
+    // which the editor reads whenever it's ready to draw its meter. If the
+    // editor isn't open, the queue fills up and new summaries are dropped.
+    GainReductionFifo gainReductionFifo{ 1024 };
 
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PressProcessor)
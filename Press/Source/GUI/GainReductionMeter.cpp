@@ -0,0 +1,103 @@
+#include "GainReductionMeter.h"
+
+//======================================================================================================================
+// The most gain reduction the meter can show, and how quickly it falls back
+// when the gain reduction drops.
+static constexpr auto maxDecibels = 24.f;
+static constexpr auto fallbackDecibelsPerSecond = 20.f;
+
+//======================================================================================================================
+GainReductionMeter::GainReductionMeter(PressProcessor::GainReductionFifo& gainReductionFifo)
+    :   fifo(gainReductionFifo),
+        lastUpdateTime(juce::Time::getMillisecondCounterHiRes()),
+        vBlankAttachment(this, [this]() { update(); })
+{
+    // Throw away anything that was queued up while the editor was closed.
+    contrast::Compressor::GainReduction gainReduction;
+
+    while (fifo.pop(gainReduction))
+        continue;
+
+    setInterceptsMouseClicks(false, false);
+}
+
+//======================================================================================================================
+void GainReductionMeter::paint(juce::Graphics& g)
+{
+    const auto primary = findColour(contrast::LookAndFeel::primaryColourId);
+
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(primary);
+    g.drawRect(bounds, contrast::defaultThickness<float>);
+    bounds.reduce(contrast::defaultThickness<float> * 2.f, contrast::defaultThickness<float> * 2.f);
+
+    g.fillRect(bounds.withRight(getXForDecibels(average)));
+
+    // The peak is drawn as a line that shows up against both the bar and
+    // the background.
+    const auto peakX = getXForDecibels(peak);
+
+    if (peak > 0.f)
+    {
+        g.setColour(findColour(contrast::LookAndFeel::secondaryColourId));
+        g.fillRect(juce::Rectangle<float>(peakX - contrast::defaultThickness<float>, bounds.getY(),
+                                          contrast::defaultThickness<float> * 2.f, bounds.getHeight()));
+        g.setColour(primary);
+        g.fillRect(juce::Rectangle<float>(peakX - contrast::defaultThickness<float> / 2.f, bounds.getY(),
+                                          contrast::defaultThickness<float>, bounds.getHeight()));
+    }
+}
+
+//======================================================================================================================
+void GainReductionMeter::update()
+{
+    auto newPeak = 0.f;
+    auto averageSum = 0.f;
+    auto numGainReductions = 0;
+
+    contrast::Compressor::GainReduction gainReduction;
+
+    while (fifo.pop(gainReduction))
+    {
+        newPeak = juce::jmax(newPeak, gainReduction.peak);
+        averageSum += gainReduction.average;
+        numGainReductions++;
+    }
+
+    const auto newAverage = numGainReductions > 0 ? averageSum / static_cast<float>(numGainReductions) : 0.f;
+
+    // Jump up to any increase in gain reduction, but fall back gradually.
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto fallback = static_cast<float>(now - lastUpdateTime) * 0.001f * fallbackDecibelsPerSecond;
+    lastUpdateTime = now;
+
+    const auto oldPeak = peak;
+    const auto oldAverage = average;
+    peak = juce::jlimit(0.f, maxDecibels, juce::jmax(newPeak, peak - fallback));
+    average = juce::jlimit(0.f, maxDecibels, juce::jmax(newAverage, average - fallback));
+
+    if (juce::approximatelyEqual(oldPeak, peak) && juce::approximatelyEqual(oldAverage, average))
+        return;
+
+    // Only the area between the old and new positions needs repainting, with
+    // a little extra either side for the peak line.
+    const float positions[] = {
+        getXForDecibels(oldPeak),
+        getXForDecibels(peak),
+        getXForDecibels(oldAverage),
+        getXForDecibels(average)
+    };
+    const auto changed = juce::Range<float>::findMinAndMax(positions, 4);
+
+    repaint(juce::Rectangle<float>(changed.getStart(), 0.f, changed.getLength(), static_cast<float>(getHeight()))
+                .expanded(contrast::defaultThickness<float> * 2.f, 0.f)
+                .getSmallestIntegerContainer());
+}
+
+float GainReductionMeter::getXForDecibels(float decibels) const
+{
+    const auto left = contrast::defaultThickness<float> * 2.f;
+    const auto right = static_cast<float>(getWidth()) - left;
+
+    return juce::jmap(decibels, 0.f, maxDecibels, left, right);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../Audio/PressProcessor.h"
+
+//======================================================================================================================
+/** A horizontal meter showing how much the compressors are reducing the
+    gain, growing from the left. The bar shows the average reduction and a
+    line marks the peak.
+
+    The meter reads the processor's gain reduction queue in time with the
+    display's refresh, and only repaints the part of itself that's changed.
+*/
+class GainReductionMeter    :   public juce::Component
+{
+public:
+    //==================================================================================================================
+    explicit GainReductionMeter(PressProcessor::GainReductionFifo&);
+
+    //==================================================================================================================
+    void paint(juce::Graphics&) override;
+
+private:
+    //==================================================================================================================
+    /** Reads any new gain reduction from the queue and updates the meter. */
+    void update();
+
+    /** Returns the x position of the given gain reduction, in decibels. */
+    float getXForDecibels(float decibels) const;
+
+    //==================================================================================================================
+    PressProcessor::GainReductionFifo& fifo;
+
+    // The values currently shown, in decibels, which fall back smoothly when
+    // the gain reduction drops.
+    float peak = 0.f;
+    float average = 0.f;
+    double lastUpdateTime = 0.0;
+
+    juce::VBlankAttachment vBlankAttachment;
+
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainReductionMeter)
+};
@@ -6,7 +6,8 @@
 PressEditor::PressEditor(PressProcessor& p)
     :   AudioProcessorEditor(&p),
         pressProcessor(p),
-        header(p.getPresetNames(), pressProcessor.getAdditionalProperty(contrast::PropertyIDs::PRESET_INDEX, 0), contrastLaF)
+        header(p.getPresetNames(), pressProcessor.getAdditionalProperty(contrast::PropertyIDs::PRESET_INDEX, 0), contrastLaF),
+        gainReductionMeter(p.getGainReductionFifo())
 {
     // Tell this Component to use the custom LookAndFeel. All child Components
     // will also use it since this it our top-level component. Also need to
@@ -41,9 +42,19 @@ PressEditor::PressEditor(PressProcessor& p)
                                "Release",   Press::ParameterIDs::RELEASE);
     contrast::initialiseSlider(*this, pressProcessor.getAPVTS(), gainSlider,      gainAttachment,
                                "Gain",      Press::ParameterIDs::GAIN);
+    contrast::initialiseSlider(*this, pressProcessor.getAPVTS(), bandsSlider,     bandsAttachment,
+                               "Bands",     Press::ParameterIDs::BANDS);
+    contrast::initialiseSlider(*this, pressProcessor.getAPVTS(), crossoverLowSlider,  crossoverLowAttachment,
+                               "Low X",     Press::ParameterIDs::CROSSOVER_LOW);
+    contrast::initialiseSlider(*this, pressProcessor.getAPVTS(), crossoverMidSlider,  crossoverMidAttachment,
+                               "Mid X",     Press::ParameterIDs::CROSSOVER_MID);
+    contrast::initialiseSlider(*this, pressProcessor.getAPVTS(), crossoverHighSlider, crossoverHighAttachment,
+                               "High X",    Press::ParameterIDs::CROSSOVER_HIGH);
+
+    addAndMakeVisible(gainReductionMeter);
 
     // Set the size of the UI.
-    setSize(476, 368);
+    setSize(476, 553);
 }
 
 PressEditor::~PressEditor()
@@ -65,6 +76,11 @@ void PressEditor::resized()
     auto bounds = getLocalBounds();
     header.setBounds(bounds.removeFromTop(header.getStandardHeight<int>()));
 
+    // The meter goes along the bottom, inset to line up with the sliders.
+    gainReductionMeter.setBounds(bounds.removeFromBottom(60)
+                                       .reduced(contrast::widgetGap<int>, 0)
+                                       .withTrimmedBottom(contrast::widgetGap<int>));
+
     juce::Grid grid;
     using TI = juce::Grid::TrackInfo;
     using Px = juce::Grid::Px;
@@ -78,12 +94,14 @@ void PressEditor::resized()
         TI(Px(contrast::sliderWidthLarge<int>))
     };
     grid.templateRows = {
+        TI(Px(contrast::getRecommendedSliderHeightForWidth(thresholdSlider, contrast::sliderWidthSmall<int>))),
         TI(Px(contrast::getRecommendedSliderHeightForWidth(thresholdSlider, contrast::sliderWidthSmall<int>))),
         TI(Px(contrast::getRecommendedSliderHeightForWidth(thresholdSlider, contrast::sliderWidthSmall<int>)))
     };
     grid.templateAreas = {
         "threshold gap ratio knee gap gain",
-        "threshold gap attack release gap gain"
+        "threshold gap attack release gap gain",
+        "bands gap crossoverLow crossoverMid gap crossoverHigh"
     };
 
     // Make sure the sliders are centered vertically and horixontally
@@ -106,6 +124,11 @@ void PressEditor::resized()
         juce::GridItem(kneeSlider)    .withArea("knee"),
         juce::GridItem(attackSlider)  .withArea("attack"),
         juce::GridItem(releaseSlider) .withArea("release"),
+        juce::GridItem(bandsSlider)   .withArea("bands"),
+
+        juce::GridItem(crossoverLowSlider)  .withArea("crossoverLow"),
+        juce::GridItem(crossoverMidSlider)  .withArea("crossoverMid"),
+        juce::GridItem(crossoverHighSlider) .withArea("crossoverHigh"),
 
         juce::GridItem(gainSlider)
             .withSize(contrast::sliderWidthLarge<float> * 1.2f,
@@ -2,6 +2,7 @@
 
 #include "JuceHeader.h"
 #include "../Audio/PressProcessor.h"
+#include "GainReductionMeter.h"
 
 //======================================================================================================================
 class PressEditor   :   public juce::AudioProcessorEditor
@@ -44,6 +45,21 @@ private:
     juce::Slider gainSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
 
+    juce::Slider bandsSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bandsAttachment;
+
+    juce::Slider crossoverLowSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverLowAttachment;
+
+    juce::Slider crossoverMidSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverMidAttachment;
+
+    juce::Slider crossoverHighSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverHighAttachment;
+
+    // Shows how much the compressors are reducing the gain, below the sliders.
+    GainReductionMeter gainReductionMeter;
+
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PressEditor)
 };
@@ -12,5 +12,16 @@ namespace Press
         constexpr char ATTACK[]    = "attack";
         constexpr char RELEASE[]   = "release";
         constexpr char GAIN[]      = "gain";
+        constexpr char BANDS[]          = "bands";
+        constexpr char CROSSOVER_LOW[]  = "crossoverLow";
+        constexpr char CROSSOVER_MID[]  = "crossoverMid";
+        constexpr char CROSSOVER_HIGH[] = "crossoverHigh";
     }
+
+    //==================================================================================================================
+    // Constants
+
+    // The maximum number of bands the signal can be split into, each with its
+    // own compressor.
+    constexpr int maxBands = contrast::LinkwitzRileyCrossover::maxBands;
 }   // namespace Press
@@ -10,19 +10,80 @@ VerbProcessor::VerbProcessor()
         damping(*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::DAMPING))),
         wet    (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::WET))),
         dry    (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::DRY))),
-        width  (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::WIDTH)))
+        width  (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::WIDTH))),
+        engine (*dynamic_cast<juce::AudioParameterChoice*>(getAPVTS().getParameter(Verb::ParameterIDs::ENGINE))),
+        economy(*dynamic_cast<juce::AudioParameterChoice*>(getAPVTS().getParameter(Verb::ParameterIDs::ECONOMY))),
+        early  (*dynamic_cast<juce::AudioParameterFloat*>(getAPVTS().getParameter(Verb::ParameterIDs::EARLY)))
 {
+    formatManager.registerBasicFormats();
+
+    getAPVTS().addParameterListener(Verb::ParameterIDs::SIZE,    this);
+    getAPVTS().addParameterListener(Verb::ParameterIDs::DAMPING, this);
+    getAPVTS().addParameterListener(Verb::ParameterIDs::WET,     this);
+    getAPVTS().addParameterListener(Verb::ParameterIDs::DRY,     this);
+    getAPVTS().addParameterListener(Verb::ParameterIDs::WIDTH,   this);
+    getAPVTS().addParameterListener(Verb::ParameterIDs::EARLY,   this);
 }
 
 VerbProcessor::~VerbProcessor()
 {
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::SIZE,    this);
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::DAMPING, this);
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::WET,     this);
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::DRY,     this);
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::WIDTH,   this);
+    getAPVTS().removeParameterListener(Verb::ParameterIDs::EARLY,   this);
 }
 
 //======================================================================================================================
-void VerbProcessor::prepareToPlay(double sampleRate, int /* blockSize */)
+void VerbProcessor::prepareToPlay(double sampleRate, int blockSize)
 {
     reverb.setSampleRate(sampleRate);
     reverb.reset();
+
+    // Debug builds accept any layout, but only as many channels as the
+    // networks can process are reverberated.
+    const auto numChannels = juce::jmin(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()),
+                                        contrast::FeedbackDelayNetwork::maxChannels);
+
+    // Each economy mode runs the networks at half the rate of the previous
+    // one.
+    for (auto mode = 0; mode < numEconomyModes; mode++)
+    {
+        const auto factor = 1 << mode;
+        const auto reducedBlockSize = blockSize / factor + 1;
+
+        smallNetworks[static_cast<std::size_t>(mode)] = std::make_unique<contrast::FeedbackDelayNetwork>(
+            8, sampleRate / factor, reducedBlockSize);
+        largeNetworks[static_cast<std::size_t>(mode)] = std::make_unique<contrast::FeedbackDelayNetwork>(
+            16, sampleRate / factor, reducedBlockSize);
+    }
+
+    resamplers.clear();
+
+    for (auto stage = 0; stage < maxResamplingStages; stage++)
+    {
+        const auto stageBlockSize = blockSize / (1 << stage) + 1;
+
+        for (auto channel = 0; channel < numChannels; channel++)
+            resamplers.push_back(std::make_unique<contrast::HalfBandResampler>(stageBlockSize));
+
+        reducedBuffers[static_cast<std::size_t>(stage)].setSize(numChannels, stageBlockSize / 2 + 1);
+    }
+
+    previousDryGain = dry * 2.f;
+
+    earlyReflections = std::make_unique<contrast::EarlyReflections>(sampleRate, blockSize);
+    wasUsingEarlyReflections = false;
+
+    // The engines have all been recreated so need the current parameters.
+    parametersChanged = true;
+
+    dryBuffer.setSize(numChannels, blockSize);
+    rebuildConvolver();
+
+    numSilentSamples = 0;
+    isAsleep = false;
 }
 
 void VerbProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
@@ -38,19 +99,122 @@ void VerbProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     if (numChannels == 0)
         return;
 
-    // Update the reverb parameters.
-    juce::Reverb::Parameters parameters;
-    parameters.roomSize = size;
-    parameters.damping = damping;
-    parameters.wetLevel = wet;
-    parameters.dryLevel = dry;
-    parameters.width = width;
-    reverb.setParameters(parameters);
+    // Only update the engines when the parameters have actually changed,
+    // since that recalculates their coefficients and restarts smoothing.
+    if (parametersChanged.exchange(false))
+        updateEngineParameters();
+
+    const auto inputIsSilent = buffer.getMagnitude(0, numSamples) < silenceThreshold;
+
+    if (! inputIsSilent)
+    {
+        numSilentSamples = 0;
+        isAsleep = false;
+    }
+    else if (isAsleep)
+    {
+        // The tail has died away so there's nothing left for the reverb to
+        // do. The dry level is still applied, scaled the same way as in the
+        // engines.
+        buffer.applyGain(dry * 2.f);
+        return;
+    }
+
+    processEngineAndEarlyReflections(buffer);
+
+    if (inputIsSilent)
+    {
+        numSilentSamples += numSamples;
+
+        // Sleep once the output has fallen silent, or once the input has
+        // been silent for the whole tail, whichever comes first. An impulse
+        // response can have quiet gaps before the rest of its tail, so the
+        // convolver only sleeps once its whole length has passed.
+        const auto sampleRate = getSampleRate();
+        const auto outputIsSilent = static_cast<Engine>(engine.getIndex()) != Engine::Impulse
+                                    && buffer.getMagnitude(0, numSamples) < silenceThreshold;
+        const auto minNumSilentSamples = static_cast<juce::int64>(minSilenceLength * sampleRate);
+        const auto tailLengthInSamples = static_cast<juce::int64>(getTailLengthSeconds() * sampleRate);
+
+        if ((outputIsSilent && numSilentSamples >= minNumSilentSamples)
+            || numSilentSamples >= juce::jmax(minNumSilentSamples, tailLengthInSamples))
+        {
+            isAsleep = true;
+            resetEngines();
+        }
+    }
+}
+
+void VerbProcessor::processEngineAndEarlyReflections(juce::AudioBuffer<float>& buffer)
+{
+    const auto useEarlyReflections = early > 0.f && earlyReflections != nullptr;
+
+    if (! useEarlyReflections)
+    {
+        wasUsingEarlyReflections = false;
+        processEngine(buffer);
+        return;
+    }
+
+    // The early reflections' history isn't kept up to date while they're
+    // turned off, so clear out whatever was left in it from before.
+    if (! wasUsingEarlyReflections)
+        earlyReflections->reset();
+
+    wasUsingEarlyReflections = true;
+
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    // The reflections are taken from the input before the engine replaces it
+    // with its output, then added on top. They always run at the full rate,
+    // even in the economy modes, since they're cheap and it's the reflections
+    // that give the impression of a room's size. Blocks are split up in case
+    // the host sends more samples than it said it would.
+    for (auto start = 0; start < numSamples; start += dryBuffer.getNumSamples())
+    {
+        const auto numChunkSamples = juce::jmin(dryBuffer.getNumSamples(), numSamples - start);
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), numChannels, start, numChunkSamples);
+
+        earlyReflections->pushInput(chunk.getArrayOfReadPointers(), numChannels, numChunkSamples);
+        processEngine(chunk);
+        earlyReflections->addReflections(chunk.getArrayOfWritePointers(), numChannels, numChunkSamples);
+    }
+}
+
+void VerbProcessor::processEngine(juce::AudioBuffer<float>& buffer)
+{
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    if (static_cast<Engine>(engine.getIndex()) == Engine::Impulse)
+    {
+        processImpulseResponse(buffer);
+        return;
+    }
 
     // Fetch the left channel data. This will also be the mono channel if
     // there's only one channel
     auto leftChannelData = buffer.getWritePointer(0);
 
+    if (auto* network = getNetwork(engine.getIndex(), economy.getIndex()))
+    {
+        // In the economy modes the network runs at a reduced rate, which is
+        // where most of its cost goes.
+        if (economy.getIndex() > 0)
+        {
+            processReducedRate(buffer, *network, economy.getIndex());
+            return;
+        }
+
+        // The networks handle any number of channels by feeding them all
+        // through the same network.
+        network->process(buffer.getArrayOfWritePointers(),
+                         juce::jmin(numChannels, contrast::FeedbackDelayNetwork::maxChannels), numSamples);
+
+        return;
+    }
+
     if (numChannels == 1)
     {
         // Process for mono.
@@ -59,7 +223,8 @@ void VerbProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     else
     {
         // If there's at least 2 channels, fetch the right channel data and then
-        // processor for stereo. Ignore any other channels.
+        // processor for stereo. juce::Reverb is stereo-only so any other
+        // channels are left dry.
         auto rightChannelData = buffer.getWritePointer(1);
         reverb.processStereo(leftChannelData, rightChannelData, numSamples);
     }
@@ -68,6 +233,398 @@ void VerbProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
 void VerbProcessor::releaseResources()
 {
     reverb.reset();
+    for (auto& network : smallNetworks)
+        network.reset();
+
+    for (auto& network : largeNetworks)
+        network.reset();
+
+    earlyReflections.reset();
+
+    std::unique_ptr<contrast::PartitionedConvolver> oldConvolver;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(convolverLock);
+        std::swap(convolver, oldConvolver);
+    }
+}
+
+double VerbProcessor::getTailLengthSeconds() const
+{
+    // The time it takes for the tail to decay below the silence threshold.
+    const auto tailDecayScale = static_cast<double>(tailDecay / 60.f);
+    auto tailLength = 0.0;
+
+    switch (static_cast<Engine>(engine.getIndex()))
+    {
+        case Engine::SmallNetwork:
+        case Engine::LargeNetwork:
+            tailLength = contrast::FeedbackDelayNetwork::getDecayTime(size) * tailDecayScale;
+            break;
+        case Engine::Impulse:
+            tailLength = impulseResponseLength.load();
+            break;
+        case Engine::Classic:
+        default:
+            tailLength = getClassicDecayTime(size) * tailDecayScale;
+            break;
+    }
+
+    // A short impulse response could finish before the last reflection.
+    if (early > 0.f)
+        tailLength = juce::jmax(tailLength, contrast::EarlyReflections::maxDelayTime);
+
+    return tailLength;
+}
+
+void VerbProcessor::setStateInformation(const void* data, int size)
+{
+    contrast::PluginProcessor::setStateInformation(data, size);
+
+    // Reload the impulse response the state was saved with.
+    const auto path = getAdditionalProperty(Verb::PropertyIDs::IMPULSE_RESPONSE_PATH).toString();
+
+    if (juce::File::isAbsolutePath(path))
+        loadImpulseResponse(juce::File(path));
+}
+
+void VerbProcessor::parameterChanged(const juce::String&, float)
+{
+    parametersChanged = true;
+}
+
+void VerbProcessor::updateEngineParameters()
+{
+    juce::Reverb::Parameters parameters;
+    parameters.roomSize = size;
+    parameters.damping = damping;
+    parameters.wetLevel = wet;
+    parameters.dryLevel = dry;
+    parameters.width = width;
+
+    // Every engine is updated, not just the current one, so that none of
+    // them are out of date if the engine or economy mode changes.
+    reverb.setParameters(parameters);
+
+    for (auto mode = 0; mode < numEconomyModes; mode++)
+    {
+        // The networks in the economy modes only produce the wet signal since
+        // the dry signal is mixed in at the full rate.
+        auto modeParameters = parameters;
+
+        if (mode > 0)
+            modeParameters.dryLevel = 0.f;
+
+        if (auto& network = smallNetworks[static_cast<std::size_t>(mode)])
+            network->setParameters(modeParameters);
+
+        if (auto& network = largeNetworks[static_cast<std::size_t>(mode)])
+            network->setParameters(modeParameters);
+    }
+
+    // The reflections are part of the wet signal so use the same scaling as
+    // the engines' wet level.
+    if (earlyReflections != nullptr)
+        earlyReflections->setParameters(size, damping, early * wet * 3.f);
+}
+
+void VerbProcessor::resetEngines()
+{
+    reverb.reset();
+
+    for (auto& network : smallNetworks)
+    {
+        if (network != nullptr)
+            network->reset();
+    }
+
+    for (auto& network : largeNetworks)
+    {
+        if (network != nullptr)
+            network->reset();
+    }
+
+    for (auto& resampler : resamplers)
+        resampler->reset();
+
+    if (earlyReflections != nullptr)
+        earlyReflections->reset();
+
+    // If a new convolver is being swapped in, it's already empty.
+    const juce::SpinLock::ScopedTryLockType lock(convolverLock);
+
+    if (lock.isLocked() && convolver != nullptr)
+        convolver->reset();
+}
+
+float VerbProcessor::getClassicDecayTime(float roomSize)
+{
+    // These match the values used internally by juce::Reverb. Its longest
+    // comb filter, 1617 samples at 44.1kHz plus the stereo spread, sets the
+    // decay. Damping only shortens the decay of the higher frequencies.
+    constexpr auto longestCombLength = (1617.f + 23.f) / 44100.f;
+    const auto feedback = roomSize * 0.28f + 0.7f;
+
+    return -3.f * longestCombLength / std::log10(feedback);
+}
+
+contrast::FeedbackDelayNetwork* VerbProcessor::getNetwork(int engineIndex, int economyIndex)
+{
+    const auto mode = static_cast<std::size_t>(juce::jlimit(0, numEconomyModes - 1, economyIndex));
+
+    switch (static_cast<Engine>(engineIndex))
+    {
+        case Engine::SmallNetwork:
+            return smallNetworks[mode].get();
+        case Engine::LargeNetwork:
+            return largeNetworks[mode].get();
+        case Engine::Classic:
+        case Engine::Impulse:
+        default:
+            return nullptr;
+    }
+}
+
+//======================================================================================================================
+bool VerbProcessor::loadImpulseResponse(const juce::File& file)
+{
+    // Only the header is read here. The rest of the file is only read if its
+    // spectra aren't already cached.
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr)
+        return false;
+
+    {
+        const juce::ScopedLock lock(impulseResponseMutex);
+        impulseResponseFile = file;
+    }
+
+    setAdditionalProperty(Verb::PropertyIDs::IMPULSE_RESPONSE_PATH, file.getFullPathName());
+    rebuildConvolver();
+
+    return true;
+}
+
+juce::AudioBuffer<float> VerbProcessor::readImpulseResponse(const juce::File& file, double sampleRate)
+{
+    // Memory map the file where the format allows it so reading it doesn't
+    // need to copy it through a stream.
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(file));
+
+        if (mappedReader != nullptr && mappedReader->mapEntireFile())
+            reader = std::move(mappedReader);
+    }
+
+    if (reader == nullptr)
+        reader.reset(formatManager.createReaderFor(file));
+
+    if (reader == nullptr)
+        return {};
+
+    const auto maxLength = static_cast<juce::int64>(reader->sampleRate * maxImpulseResponseLength);
+    const auto length = static_cast<int>(juce::jmin(reader->lengthInSamples, maxLength));
+    const auto numChannels = static_cast<int>(juce::jmin(reader->numChannels,
+                                                         static_cast<unsigned int>(contrast::FeedbackDelayNetwork::maxChannels)));
+
+    juce::AudioBuffer<float> impulseResponse(numChannels, length);
+    reader->read(&impulseResponse, 0, length, 0, true, numChannels > 1);
+
+    // Resample the impulse response to the given sample rate.
+    const auto ratio = reader->sampleRate / sampleRate;
+    const auto resampledLength = static_cast<int>(juce::jmin(std::ceil(length / ratio),
+                                                             static_cast<double>(contrast::PartitionedConvolver::maxImpulseLength)));
+    juce::AudioBuffer<float> resampled(numChannels, resampledLength);
+
+    for (auto channel = 0; channel < numChannels; channel++)
+    {
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, impulseResponse.getReadPointer(channel), resampled.getWritePointer(channel),
+                             resampledLength, length, 0);
+    }
+
+    // Normalise the impulse response so its loudest channel has an energy of
+    // -20dB, which puts it at about the same level as the other engines.
+    auto maxEnergy = 0.f;
+
+    for (auto channel = 0; channel < numChannels; channel++)
+    {
+        const auto rms = resampled.getRMSLevel(channel, 0, resampledLength);
+        maxEnergy = juce::jmax(maxEnergy, rms * rms * static_cast<float>(resampledLength));
+    }
+
+    if (maxEnergy > 0.f)
+        resampled.applyGain(0.1f / std::sqrt(maxEnergy));
+
+    return resampled;
+}
+
+void VerbProcessor::rebuildConvolver()
+{
+    const auto sampleRate = getSampleRate();
+
+    // Nothing to build until the processor has been prepared.
+    if (sampleRate <= 0.0)
+        return;
+
+    juce::File file;
+
+    {
+        const juce::ScopedLock lock(impulseResponseMutex);
+        file = impulseResponseFile;
+    }
+
+    std::unique_ptr<contrast::PartitionedConvolver> newConvolver;
+
+    if (file != juce::File())
+    {
+        // The spectra are shared with any other instance using the same
+        // impulse response, and cached on disk so they're only calculated
+        // once.
+        const auto spectra = impulseResponseCache->getSpectra(file, sampleRate,
+                                                              [this](const juce::File& f, double rate) {
+                                                                  return readImpulseResponse(f, rate);
+                                                              });
+
+        if (spectra != nullptr)
+        {
+            impulseResponseLength = spectra->getImpulseLength() / sampleRate;
+
+            const auto numChannels = juce::jmax(1, getTotalNumInputChannels(), getTotalNumOutputChannels());
+            newConvolver = std::make_unique<contrast::PartitionedConvolver>(spectra, numChannels, sampleRate);
+        }
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(convolverLock);
+        std::swap(convolver, newConvolver);
+    }
+
+    // The old convolver, now in newConvolver, is destroyed here, outside of
+    // the lock.
+}
+
+void VerbProcessor::processReducedRate(juce::AudioBuffer<float>& buffer, contrast::FeedbackDelayNetwork& network,
+                                       int numStages)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels(),
+                                        contrast::FeedbackDelayNetwork::maxChannels);
+    const auto numSamples = buffer.getNumSamples();
+    numStages = juce::jlimit(1, maxResamplingStages, numStages);
+
+    // Only the wet signal goes through the network. The dry signal is mixed
+    // in here, at the full rate, using the same scaling as the engines.
+    const auto dryGain = dry * 2.f;
+
+    std::array<float*, contrast::FeedbackDelayNetwork::maxChannels> channels{};
+    std::array<int, maxResamplingStages + 1> numStageSamples{};
+
+    for (auto start = 0; start < numSamples; start += dryBuffer.getNumSamples())
+    {
+        numStageSamples[0] = juce::jmin(dryBuffer.getNumSamples(), numSamples - start);
+
+        for (auto channel = 0; channel < numChannels; channel++)
+            dryBuffer.copyFrom(channel, 0, buffer, channel, start, numStageSamples[0]);
+
+        // Halve the rate once for each stage.
+        for (auto stage = 0; stage < numStages; stage++)
+        {
+            auto& stageBuffer = getReducedBuffer(stage);
+
+            for (auto channel = 0; channel < numChannels; channel++)
+            {
+                const auto* input = stage == 0 ? dryBuffer.getReadPointer(channel)
+                                               : getReducedBuffer(stage - 1).getReadPointer(channel);
+
+                numStageSamples[static_cast<std::size_t>(stage + 1)] = getResampler(stage, channel).downsample(
+                    input, stageBuffer.getWritePointer(channel), numStageSamples[static_cast<std::size_t>(stage)]);
+            }
+        }
+
+        for (auto channel = 0; channel < numChannels; channel++)
+            channels[static_cast<std::size_t>(channel)] = getReducedBuffer(numStages - 1).getWritePointer(channel);
+
+        network.process(channels.data(), numChannels, numStageSamples[static_cast<std::size_t>(numStages)]);
+
+        // Then double it again, from the lowest rate back up to the full
+        // rate.
+        for (auto stage = numStages - 1; stage >= 0; stage--)
+        {
+            const auto& stageBuffer = getReducedBuffer(stage);
+
+            for (auto channel = 0; channel < numChannels; channel++)
+            {
+                auto* output = stage == 0 ? buffer.getWritePointer(channel, start)
+                                          : getReducedBuffer(stage - 1).getWritePointer(channel);
+
+                getResampler(stage, channel).upsample(stageBuffer.getReadPointer(channel),
+                                                      numStageSamples[static_cast<std::size_t>(stage + 1)],
+                                                      output, numStageSamples[static_cast<std::size_t>(stage)]);
+            }
+        }
+
+        for (auto channel = 0; channel < numChannels; channel++)
+            buffer.addFromWithRamp(channel, start, dryBuffer.getReadPointer(channel), numStageSamples[0], previousDryGain, dryGain);
+
+        previousDryGain = dryGain;
+    }
+}
+
+contrast::HalfBandResampler& VerbProcessor::getResampler(int stage, int channel)
+{
+    return *resamplers[static_cast<std::size_t>(stage * dryBuffer.getNumChannels() + channel)];
+}
+
+juce::AudioBuffer<float>& VerbProcessor::getReducedBuffer(int stage)
+{
+    return reducedBuffers[static_cast<std::size_t>(stage)];
+}
+
+void VerbProcessor::processImpulseResponse(juce::AudioBuffer<float>& buffer)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels(),
+                                        contrast::FeedbackDelayNetwork::maxChannels);
+    const auto numSamples = buffer.getNumSamples();
+
+    // Use the same scaling of the wet and dry levels as the other engines.
+    const auto wetGain = wet * 3.f;
+    const auto dryGain = dry * 2.f;
+
+    const juce::SpinLock::ScopedTryLockType lock(convolverLock);
+
+    // If there's no impulse response loaded, or a new one is being swapped
+    // in, there's nothing to convolve with so only the dry signal is output.
+    if (! lock.isLocked() || convolver == nullptr)
+    {
+        buffer.applyGain(dryGain);
+        return;
+    }
+
+    std::array<float*, contrast::FeedbackDelayNetwork::maxChannels> channels{};
+
+    for (auto start = 0; start < numSamples; start += dryBuffer.getNumSamples())
+    {
+        const auto numChunkSamples = juce::jmin(dryBuffer.getNumSamples(), numSamples - start);
+
+        for (auto channel = 0; channel < numChannels; channel++)
+        {
+            dryBuffer.copyFrom(channel, 0, buffer, channel, start, numChunkSamples);
+            channels[static_cast<std::size_t>(channel)] = buffer.getWritePointer(channel, start);
+        }
+
+        convolver->process(channels.data(), numChannels, numChunkSamples);
+
+        for (auto channel = 0; channel < numChannels; channel++)
+        {
+            auto* samples = channels[static_cast<std::size_t>(channel)];
+            juce::FloatVectorOperations::multiply(samples, wetGain, numChunkSamples);
+            juce::FloatVectorOperations::addWithMultiply(samples, dryBuffer.getReadPointer(channel), dryGain, numChunkSamples);
+        }
+    }
 }
 
 #if JUCE_DEBUG
@@ -78,10 +635,14 @@ bool VerbProcessor::isBusesLayoutSupported(const BusesLayout&) const
 #else
 bool VerbProcessor::isBusesLayoutSupported(const BusesLayout& layout) const
 {
-    // Only support mono or stereo layouts where the input and output layouts
-    // match.
-    return layout.inputBuses.size() <= 2
-           && layout.inputBuses.size() == layout.outputBuses.size();
+    // Support any layout, from mono up to the most channels the networks can
+    // process (enough for 7.1.4 and similar), where the input and output
+    // layouts match.
+    const auto& outputChannels = layout.getMainOutputChannelSet();
+
+    return layout.getMainInputChannelSet() == outputChannels
+           && ! outputChannels.isDisabled()
+           && outputChannels.size() <= contrast::FeedbackDelayNetwork::maxChannels;
 }
 #endif
 
@@ -185,13 +746,57 @@ juce::AudioProcessorValueTreeState::ParameterLayout VerbProcessor::createParamet
                 return text.getFloatValue() / 100.f;
             }));
 
+    // The classic engine is juce::Reverb. The network engines are feedback
+    // delay networks with 8 or 16 delay lines, which give a denser tail. The
+    // impulse engine convolves with a loaded impulse response.
+    auto engineParam = std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{
+            Verb::ParameterIDs::ENGINE,
+            1,
+        },
+        "Engine",
+        juce::StringArray{ "Classic", "FDN 8", "FDN 16", "Impulse" },
+        0);
+
+    // The economy modes run the network engines at half or quarter rate,
+    // which saves a lot of CPU at high sample rates where there's little in
+    // the tail above the reduced Nyquist frequency anyway.
+    auto economyParam = std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{
+            Verb::ParameterIDs::ECONOMY,
+            1,
+        },
+        "Economy",
+        juce::StringArray{ "Off", "Half", "Quarter" },
+        0);
+
+    // The level of the early reflections, which are modelled on a room whose
+    // dimensions follow the size parameter. They're off by default so
+    // existing sessions sound the same as they did before.
+    auto earlyParam = std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{
+            Verb::ParameterIDs::EARLY,
+            1,
+        },
+        "Early",
+        juce::NormalisableRange<float>(0.f, 1.f),
+        0.f,
+        juce::AudioParameterFloatAttributes{}
+            .withStringFromValueFunction([](float value, int) -> juce::String {
+                return contrast::pretifyValue(value * 100.f, 3) + "%";
+            })
+            .withValueFromStringFunction([](const juce::String& text) -> float {
+                return text.getFloatValue() / 100.f;
+            }));
+
     // In this plugin we only have one, unnamed group that all of our parameters
     // will live in.
     std::vector<std::unique_ptr<juce::AudioProcessorParameterGroup>> groups;
     groups.push_back(std::make_unique<juce::AudioProcessorParameterGroup>(
         "verb", "Verb", "",
         std::move(sizeParam), std::move(dampingParam), std::move(wetParam),
-        std::move(dryParam), std::move(widthParam)
+        std::move(dryParam), std::move(widthParam), std::move(engineParam),
+        std::move(economyParam), std::move(earlyParam)
     ));
 
     return { groups.begin(), groups.end() };
@@ -200,6 +805,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout VerbProcessor::createParamet
 juce::ValueTree VerbProcessor::createDefaultProperties() const
 {
     juce::ValueTree tree("ADDITIONAL_PROPERTIES");
+    tree.setProperty(Verb::PropertyIDs::IMPULSE_RESPONSE_PATH, "", nullptr);
     return tree;
 }
 
@@ -3,7 +3,8 @@
 #include "JuceHeader.h"
 
 //======================================================================================================================
-class VerbProcessor   :   public contrast::PluginProcessor
+class VerbProcessor   :   public contrast::PluginProcessor,
+                          private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==================================================================================================================
@@ -17,29 +18,171 @@ public:
 
     bool isBusesLayoutSupported(const BusesLayout&) const override;
 
+    double getTailLengthSeconds() const override;
+
+    void setStateInformation(const void*, int) override;
+
     //==================================================================================================================
     juce::AudioProcessorEditor* createEditor() override;
 
     //==================================================================================================================
     juce::StringArray getPresetNames() const override;
 
+    //==================================================================================================================
+    /** Loads the impulse response used by the impulse engine from the given
+        audio file. Returns false if the file couldn't be read.
+
+        This should be called from the message thread.
+    */
+    bool loadImpulseResponse(const juce::File&);
+
 private:
     //==================================================================================================================
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout() const override;
     juce::ValueTree createDefaultProperties() const override;
     void presetChoiceChanged(int) override;
+    void parameterChanged(const juce::String&, float) override;
+
+    /** Applies the current parameters to every engine. */
+    void updateEngineParameters();
+
+    /** Returns the network used by the given engine in the given economy
+        mode, or nullptr if the engine doesn't use one.
+    */
+    contrast::FeedbackDelayNetwork* getNetwork(int engineIndex, int economyIndex);
+
+    /** Creates a new convolver for the loaded impulse response at the current
+        sample rate and swaps it in for the current one.
+    */
+    void rebuildConvolver();
+
+    /** Reads the impulse response from the given file, resampled to the given
+        sample rate and normalised.
+    */
+    juce::AudioBuffer<float> readImpulseResponse(const juce::File&, double sampleRate);
+
+    /** Applies the current engine and the early reflections to the given
+        buffer.
+    */
+    void processEngineAndEarlyReflections(juce::AudioBuffer<float>&);
+
+    /** Applies the current engine to the given buffer. */
+    void processEngine(juce::AudioBuffer<float>&);
+
+    /** Applies the given network to the given buffer at a reduced sample
+        rate, with the dry signal mixed in at the full rate.
+    */
+    void processReducedRate(juce::AudioBuffer<float>&, contrast::FeedbackDelayNetwork&, int numStages);
+
+    /** Returns the resampler for the given stage of the given channel. */
+    contrast::HalfBandResampler& getResampler(int stage, int channel);
+
+    /** Returns the buffer holding the output of the given resampling stage. */
+    juce::AudioBuffer<float>& getReducedBuffer(int stage);
+
+    /** Applies the impulse engine to the given buffer. */
+    void processImpulseResponse(juce::AudioBuffer<float>&);
+
+    /** Clears the state of every engine. */
+    void resetEngines();
+
+    /** Returns the time, in seconds, it takes the classic engine's output to
+        decay by 60dB with the given room size.
+    */
+    static float getClassicDecayTime(float roomSize);
+
+    //==================================================================================================================
+    // The reverb algorithms that can be selected with the engine parameter.
+    enum class Engine
+    {
+        Classic,
+        SmallNetwork,
+        LargeNetwork,
+        Impulse
+    };
+
+    // The network engines can run at full, half or quarter rate, each of
+    // which halves the rate again using another resampling stage.
+    static constexpr int numEconomyModes = 3;
+    static constexpr int maxResamplingStages = numEconomyModes - 1;
+
+    // The longest impulse response that can be loaded, in seconds.
+    static constexpr double maxImpulseResponseLength = 20.0;
+
+    // The level, as a gain, below which the input and output are considered
+    // silent. This is -90dB.
+    static constexpr float silenceThreshold = 0.0000316f;
+
+    // How far, in dB, the tail has to decay to fall below the silence
+    // threshold from a full-scale input.
+    static constexpr float tailDecay = 90.f;
+
+    // The shortest time, in seconds, the input has to be silent before the
+    // reverb can sleep, which gives the reverb time to build up before its
+    // output is checked.
+    static constexpr double minSilenceLength = 0.2;
 
     //==================================================================================================================
     // The Reverb effecct this plugin will use.
     // It handles stereo so we only need the one.
     juce::Reverb reverb;
 
+    // The feedback delay networks used by the other engines, for each
+    // economy mode. All are created in prepareToPlay() so the engine and
+    // economy mode can be changed without allocating.
+    std::array<std::unique_ptr<contrast::FeedbackDelayNetwork>, numEconomyModes> smallNetworks;
+    std::array<std::unique_ptr<contrast::FeedbackDelayNetwork>, numEconomyModes> largeNetworks;
+
+    // The resamplers used in the economy modes, with one for each stage of
+    // each channel, and the buffers holding the output of each stage.
+    std::vector<std::unique_ptr<contrast::HalfBandResampler>> resamplers;
+    std::array<juce::AudioBuffer<float>, maxResamplingStages> reducedBuffers;
+    float previousDryGain = 0.f;
+
+    // Adds the early reflections of a room, on top of any engine.
+    std::unique_ptr<contrast::EarlyReflections> earlyReflections;
+    bool wasUsingEarlyReflections = false;
+
+    // The file of the loaded impulse response, guarded by a lock since it
+    // may be loaded and used by different non-audio threads.
+    juce::CriticalSection impulseResponseMutex;
+    juce::File impulseResponseFile;
+    juce::SharedResourcePointer<contrast::ImpulseResponseCache> impulseResponseCache;
+
+    // The convolver used by the impulse engine. New convolvers are built off
+    // the audio thread then swapped in while holding the spin lock, which the
+    // audio thread only ever tries to take.
+    juce::SpinLock convolverLock;
+    std::unique_ptr<contrast::PartitionedConvolver> convolver;
+
+    // Holds a copy of the dry signal while the impulse engine is processing.
+    juce::AudioBuffer<float> dryBuffer;
+
+    // The length of the loaded impulse response, in seconds, which is the
+    // impulse engine's tail length.
+    std::atomic<double> impulseResponseLength{ 0.0 };
+
+    // Once the input has been silent long enough for the tail to die away,
+    // the reverb goes to sleep and stops processing until the input is no
+    // longer silent.
+    juce::int64 numSilentSamples = 0;
+    bool isAsleep = false;
+
+    juce::AudioFormatManager formatManager;
+
+    // Set whenever one of the engines' parameters changes, so they're only
+    // updated when they need to be.
+    std::atomic<bool> parametersChanged{ true };
+
     // Hold references to the parameters for easy access.
     juce::AudioParameterFloat& size;
     juce::AudioParameterFloat& damping;
     juce::AudioParameterFloat& wet;
     juce::AudioParameterFloat& dry;
     juce::AudioParameterFloat& width;
+    juce::AudioParameterChoice& engine;
+    juce::AudioParameterChoice& economy;
+    juce::AudioParameterFloat& early;
 
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VerbProcessor)
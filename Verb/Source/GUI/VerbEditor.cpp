@@ -39,9 +39,34 @@ VerbEditor::VerbEditor(VerbProcessor& p)
                                "Dry",     Verb::ParameterIDs::DRY);
     contrast::initialiseSlider(*this, verbProcessor.getAPVTS(), widthSlider,   widthAttachment,
                                "Width",   Verb::ParameterIDs::WIDTH);
+    contrast::initialiseSlider(*this, verbProcessor.getAPVTS(), engineSlider,  engineAttachment,
+                               "Engine",  Verb::ParameterIDs::ENGINE);
+    contrast::initialiseSlider(*this, verbProcessor.getAPVTS(), economySlider, economyAttachment,
+                               "Economy", Verb::ParameterIDs::ECONOMY);
+    contrast::initialiseSlider(*this, verbProcessor.getAPVTS(), earlySlider,   earlyAttachment,
+                               "Early",   Verb::ParameterIDs::EARLY);
+
+    // Show the name of the current impulse response, if there is one, on the
+    // button used to load a new one.
+    const juce::File impulseResponseFile = verbProcessor.getAdditionalProperty(Verb::PropertyIDs::IMPULSE_RESPONSE_PATH).toString();
+
+    if (impulseResponseFile.existsAsFile())
+        loadImpulseResponseButton.setButtonText(impulseResponseFile.getFileNameWithoutExtension());
+
+    addAndMakeVisible(loadImpulseResponseButton);
+    loadImpulseResponseButton.onClick = [this]() {
+        fileChooser = std::make_unique<juce::FileChooser>("Load Impulse Response", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+        fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                 [this](const juce::FileChooser& chooser) {
+                                     const auto file = chooser.getResult();
+
+                                     if (file.existsAsFile() && verbProcessor.loadImpulseResponse(file))
+                                         loadImpulseResponseButton.setButtonText(file.getFileNameWithoutExtension());
+                                 });
+    };
 
     // Set the size of the UI.
-    setSize(356, 368);
+    setSize(441, 503);
 }
 
 VerbEditor::~VerbEditor()
@@ -67,8 +92,8 @@ void VerbEditor::resized()
     using TI = juce::Grid::TrackInfo;
     using Px = juce::Grid::Px;
 
-    grid.templateColumns =  { TI(Px(80)), TI(Px(0)), TI(Px(65)), TI(Px(65)) };
-    grid.templateRows =     { TI(Px(115)), TI(Px(115)) };
+    grid.templateColumns =  { TI(Px(80)), TI(Px(0)), TI(Px(65)), TI(Px(65)), TI(Px(65)) };
+    grid.templateRows =     { TI(Px(115)), TI(Px(115)), TI(Px(115)) };
 
     // Make sure the sliders are centered vertically and horixontally
     grid.justifyContent = juce::Grid::JustifyContent::center;
@@ -98,13 +123,27 @@ void VerbEditor::resized()
         juce::GridItem(widthSlider)
             .withSize(65.f, heightForWidth(widthSlider, 65.f)),
 
+        juce::GridItem(engineSlider)
+            .withSize(65.f, heightForWidth(engineSlider, 65.f)),
+
         juce::GridItem(),
 
         juce::GridItem(wetSlider)
             .withSize(65.f, heightForWidth(wetSlider, 65.f)),
 
         juce::GridItem(drySlider)
-            .withSize(65.f, heightForWidth(drySlider, 65.f))
+            .withSize(65.f, heightForWidth(drySlider, 65.f)),
+
+        juce::GridItem(loadImpulseResponseButton)
+            .withSize(65.f, 30.f),
+
+        juce::GridItem(earlySlider)
+            .withSize(65.f, heightForWidth(earlySlider, 65.f))
+            .withArea(3, 4),
+
+        juce::GridItem(economySlider)
+            .withSize(65.f, heightForWidth(economySlider, 65.f))
+            .withArea(3, 5)
     };
 
     // Get the bounds of the actual 'useable' area of the UI.
@@ -40,6 +40,20 @@ private:
     juce::Slider widthSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> widthAttachment;
 
+    juce::Slider engineSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> engineAttachment;
+
+    juce::Slider economySlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> economyAttachment;
+
+    juce::Slider earlySlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> earlyAttachment;
+
+    // Opens a file chooser to load the impulse response used by the impulse
+    // engine.
+    juce::TextButton loadImpulseResponseButton{ "Load IR" };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
     //==================================================================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VerbEditor)
 };
@@ -11,5 +11,14 @@ namespace Verb
         constexpr char WET[]     = "wet";
         constexpr char DRY[]     = "dry";
         constexpr char WIDTH[]   = "width";
+        constexpr char ENGINE[]  = "engine";
+        constexpr char ECONOMY[] = "economy";
+        constexpr char EARLY[]   = "early";
     }   // namespace ParameterIDs
+
+    //==================================================================================================================
+    namespace PropertyIDs
+    {
+        constexpr char IMPULSE_RESPONSE_PATH[] = "impulseResponsePath";
+    }   // namespace PropertyIDs
 }   // namespace Verb
@@ -0,0 +1,158 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** A biquad filter in transposed direct form II.
+
+        The sample type can be a float or double, or a juce::dsp::SIMDRegister
+        to process several signals at once in the register's lanes, each with
+        its own state but sharing the same coefficients. The processing only
+        uses additions and multiplications so the same code works for both.
+
+        The coefficients are normalised so a0 is 1, and are calculated using
+        the formulas from Robert Bristow-Johnson's Audio EQ Cookbook.
+    */
+    template <typename SampleType>
+    class Biquad
+    {
+    public:
+        //==============================================================================================================
+        /** The coefficients of a biquad, with a0 normalised to 1. */
+        struct Coefficients
+        {
+            float b0 = 1.f;
+            float b1 = 0.f;
+            float b2 = 0.f;
+            float a1 = 0.f;
+            float a2 = 0.f;
+        };
+
+        //==============================================================================================================
+        /** Returns the coefficients of a low-pass filter with the given cutoff
+            frequency and Q.
+        */
+        static Coefficients makeLowPass(double sampleRate, double frequency, double q)
+        {
+            const auto [cosW, alpha] = getCosAndAlpha(sampleRate, frequency, q);
+            return normalise((1.0 - cosW) / 2.0, 1.0 - cosW, (1.0 - cosW) / 2.0, 1.0 + alpha, -2.0 * cosW, 1.0 - alpha);
+        }
+
+        /** Returns the coefficients of a high-pass filter with the given
+            cutoff frequency and Q.
+        */
+        static Coefficients makeHighPass(double sampleRate, double frequency, double q)
+        {
+            const auto [cosW, alpha] = getCosAndAlpha(sampleRate, frequency, q);
+            return normalise((1.0 + cosW) / 2.0, -(1.0 + cosW), (1.0 + cosW) / 2.0, 1.0 + alpha, -2.0 * cosW, 1.0 - alpha);
+        }
+
+        /** Returns the coefficients of an all-pass filter with the given
+            centre frequency and Q.
+        */
+        static Coefficients makeAllPass(double sampleRate, double frequency, double q)
+        {
+            const auto [cosW, alpha] = getCosAndAlpha(sampleRate, frequency, q);
+            return normalise(1.0 - alpha, -2.0 * cosW, 1.0 + alpha, 1.0 + alpha, -2.0 * cosW, 1.0 - alpha);
+        }
+
+        //==============================================================================================================
+        /** Sets the filter's coefficients. The state is kept so the filter
+            can be changed while it's running.
+        */
+        void setCoefficients(const Coefficients& newCoefficients)
+        {
+            b0 = static_cast<SampleType>(newCoefficients.b0);
+            b1 = static_cast<SampleType>(newCoefficients.b1);
+            b2 = static_cast<SampleType>(newCoefficients.b2);
+            a1 = static_cast<SampleType>(newCoefficients.a1);
+            a2 = static_cast<SampleType>(newCoefficients.a2);
+        }
+
+        /** Sets the coefficients used by a single lane when the sample type
+            is a juce::dsp::SIMDRegister, so each lane can have a different
+            filter. The state is kept, as with setCoefficients().
+        */
+        void setCoefficients(const Coefficients& newCoefficients, std::size_t lane)
+        {
+            b0.set(lane, newCoefficients.b0);
+            b1.set(lane, newCoefficients.b1);
+            b2.set(lane, newCoefficients.b2);
+            a1.set(lane, newCoefficients.a1);
+            a2.set(lane, newCoefficients.a2);
+        }
+
+        /** Clears the filter's state. */
+        void reset()
+        {
+            state1 = static_cast<SampleType>(0.f);
+            state2 = static_cast<SampleType>(0.f);
+        }
+
+        //==============================================================================================================
+        /** Filters a single sample. */
+        SampleType processSample(SampleType input)
+        {
+            const auto output = b0 * input + state1;
+            state1 = b1 * input - a1 * output + state2;
+            state2 = b2 * input - a2 * output;
+
+            return output;
+        }
+
+        /** Filters the given samples in place. */
+        void process(SampleType* samples, int numSamples)
+        {
+            // Work on local copies so the compiler can keep everything in
+            // registers for the whole block.
+            auto s1 = state1;
+            auto s2 = state2;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                const auto input = samples[i];
+                const auto output = b0 * input + s1;
+                s1 = b1 * input - a1 * output + s2;
+                s2 = b2 * input - a2 * output;
+                samples[i] = output;
+            }
+
+            state1 = s1;
+            state2 = s2;
+        }
+
+    private:
+        //==============================================================================================================
+        static std::pair<double, double> getCosAndAlpha(double sampleRate, double frequency, double q)
+        {
+            // Keep the frequency just below Nyquist so the filter is stable.
+            frequency = juce::jlimit(1.0, sampleRate * 0.499, frequency);
+
+            const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            return { std::cos(w), std::sin(w) / (2.0 * q) };
+        }
+
+        static Coefficients normalise(double newB0, double newB1, double newB2, double newA0, double newA1,
+                                      double newA2)
+        {
+            return {
+                static_cast<float>(newB0 / newA0),
+                static_cast<float>(newB1 / newA0),
+                static_cast<float>(newB2 / newA0),
+                static_cast<float>(newA1 / newA0),
+                static_cast<float>(newA2 / newA0)
+            };
+        }
+
+        //==============================================================================================================
+        SampleType b0{ 1.f };
+        SampleType b1{ 0.f };
+        SampleType b2{ 0.f };
+        SampleType a1{ 0.f };
+        SampleType a2{ 0.f };
+
+        SampleType state1{ 0.f };
+        SampleType state2{ 0.f };
+    };
+}   // namespace contrast
@@ -7,6 +7,19 @@ namespace contrast
     class Compressor
     {
     public:
+        //==============================================================================================================
+        /** The gain reduction applied over a block of samples, in decibels.
+            Both values are positive, and zero when nothing was compressed.
+        */
+        struct GainReduction
+        {
+            // The most gain reduction applied to any sample.
+            float peak = 0.f;
+
+            // The mean gain across the block, as a reduction.
+            float average = 0.f;
+        };
+
         //==============================================================================================================
         Compressor(float sampleRate)
             :   follower(sampleRate)
@@ -53,6 +66,77 @@ namespace contrast
             return gain * input * makeupGain;
         }
 
+        /** Compresses the given samples in place, the same as calling
+            processSample() for each of them, and records the gain reduction
+            applied over them, which can be read with getGainReduction().
+        */
+        void process(float* samples, int numSamples)
+        {
+            if (numSamples <= 0)
+                return;
+
+            // With a 1:1 ratio and no makeup gain the samples would be left
+            // untouched, so only the envelope is followed, to keep it up to
+            // date for when the settings change.
+            if (isNeutral())
+            {
+                for (auto i = 0; i < numSamples; i++)
+                    follower.processSample(samples[i]);
+
+                gainReduction = {};
+                return;
+            }
+
+            // The gains are summed as linear values so the only conversion to
+            // decibels is done once at the end of the block.
+            auto minimumGain = 1.f;
+            auto gainSum = 0.f;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                const auto envelopeDB = juce::Decibels::gainToDecibels(follower.processSample(samples[i]));
+
+                if (envelopeDB <= threshold - knee / 2.f)
+                {
+                    gainSum += 1.f;
+                    continue;
+                }
+
+                const auto gain = calculateGain(envelopeDB);
+                samples[i] *= gain * makeupGain;
+
+                minimumGain = juce::jmin(minimumGain, gain);
+                gainSum += gain;
+            }
+
+            gainReduction = makeGainReduction(minimumGain, gainSum / static_cast<float>(numSamples));
+        }
+
+        /** Returns true if the compressor's current settings leave the signal
+            unchanged.
+        */
+        bool isNeutral() const noexcept
+        {
+            return ratio == 1.f && makeupGain == 1.f;
+        }
+
+        /** Returns the gain reduction applied by the last call to process(). */
+        GainReduction getGainReduction() const noexcept
+        {
+            return gainReduction;
+        }
+
+        /** Returns the gain reduction corresponding to the given minimum and
+            mean linear gains.
+        */
+        static GainReduction makeGainReduction(float minimumGain, float meanGain)
+        {
+            return {
+                -juce::Decibels::gainToDecibels(minimumGain),
+                -juce::Decibels::gainToDecibels(meanGain)
+            };
+        }
+
         //==============================================================================================================
         void setThreshold(float newThreshold)
         {
@@ -95,5 +179,7 @@ namespace contrast
         float ratio = 1.f;
         float knee = 0.f;
         float makeupGain = 1.f;
+
+        GainReduction gainReduction;
     };
 }   // namespace contrast
@@ -66,15 +66,53 @@ namespace contrast
             // Find the index in the delay line to read from.
             // The index should be N less than the write index, wrapped around
             // if that makes it negative.
-            auto index = writeIndex - length;
-
-            if (index < 0)
-                index += capacity;
+            // The indices are unsigned so the wrap has to be checked before
+            // subtracting.
+            const auto currentLength = length.load();
+            const auto index = writeIndex >= currentLength ? writeIndex - currentLength
+                                                           : writeIndex + capacity - currentLength;
 
             // Return the value from the delay line with the calculated index.
             return delayLine[index];
         }
 
+        /** Writes the given values to the delay line and fills the output with
+            the delayed values.
+
+            This is the same as calling read() then write() for each value but
+            copies whole spans of the delay line at a time.
+        */
+        void process(const ValueType* input, ValueType* output, std::size_t numValues)
+        {
+            const auto currentLength = length.load();
+            jassert(currentLength + 1 < capacity);
+
+            // If the delay is shorter than the block, values written by this
+            // call will be read back by it, so the block is split into chunks
+            // short enough that writing a chunk never overwrites values that
+            // are still to be read.
+            const auto maxChunkSize = capacity > currentLength + 1 ? capacity - currentLength - 1 : 1;
+
+            while (numValues > 0)
+            {
+                const auto chunkSize = std::min(numValues, maxChunkSize);
+
+                // The first value is read from N before the current write
+                // index, and written just after it.
+                const auto readIndex = writeIndex >= currentLength ? writeIndex - currentLength
+                                                                   : writeIndex + capacity - currentLength;
+
+                copyToDelayLine(input, (writeIndex + 1) % capacity, chunkSize);
+                copyFromDelayLine(output, readIndex, chunkSize);
+
+                writeIndex = (writeIndex + chunkSize) % capacity;
+
+                input += chunkSize;
+                output += chunkSize;
+                numValues -= chunkSize;
+            }
+        }
+
         /** Resets the delay line to zeros. */
         void reset()
         {
@@ -83,6 +121,31 @@ namespace contrast
         }
 
     private:
+        //==============================================================================================================
+        /** Copies the given values into the delay line from the given index,
+            wrapping around the end of the delay line if needed.
+        */
+        void copyToDelayLine(const ValueType* source, std::size_t startIndex, std::size_t numValues)
+        {
+            const auto numBeforeWrap = std::min(numValues, capacity - startIndex);
+
+            std::copy(source, source + numBeforeWrap, delayLine.begin() + static_cast<std::ptrdiff_t>(startIndex));
+            std::copy(source + numBeforeWrap, source + numValues, delayLine.begin());
+        }
+
+        /** Copies values out of the delay line from the given index, wrapping
+            around the end of the delay line if needed.
+        */
+        void copyFromDelayLine(ValueType* destination, std::size_t startIndex, std::size_t numValues) const
+        {
+            const auto numBeforeWrap = std::min(numValues, capacity - startIndex);
+            const auto start = delayLine.begin() + static_cast<std::ptrdiff_t>(startIndex);
+
+            std::copy(start, start + static_cast<std::ptrdiff_t>(numBeforeWrap), destination);
+            std::copy(delayLine.begin(), delayLine.begin() + static_cast<std::ptrdiff_t>(numValues - numBeforeWrap),
+                      destination + numBeforeWrap);
+        }
+
         //==============================================================================================================
         // The maximum size of the delayLine.
         const std::size_t capacity;
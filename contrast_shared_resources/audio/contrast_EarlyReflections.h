@@ -0,0 +1,295 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Adds the early reflections of a room to a signal using a multi-tap
+        delay.
+
+        The taps are calculated from a simple model of a rectangular room
+        using image sources: each reflection off a wall is treated as a copy
+        of the source mirrored in that wall, and its delay and gain come from
+        its distance to the listener. The first and second order reflections
+        are used, which gives numTaps taps for each of the listener's ears.
+
+        The input is written to a delay line a whole block at a time, then
+        each tap is added to the output as a contiguous span of the delay line
+        using vectorised operations, so the cost is a handful of vector
+        multiply-adds per tap per block.
+    */
+    class EarlyReflections
+    {
+    public:
+        //==============================================================================================================
+        /** The number of taps for each ear. */
+        static constexpr int numTaps = 24;
+
+        /** The longest delay of any tap, in seconds. */
+        static constexpr double maxDelayTime = 0.25;
+
+        /** The most channels that can be processed. */
+        static constexpr int maxChannels = 16;
+
+        //==============================================================================================================
+        EarlyReflections(double sampleRate, int maximumBlockSize)
+            :   currentSampleRate(sampleRate),
+                maxBlockSize(maximumBlockSize)
+        {
+            const auto maxDelay = static_cast<int>(std::ceil(maxDelayTime * sampleRate));
+            bufferSize = juce::nextPowerOfTwo(maxDelay + maximumBlockSize + 1);
+            buffer.resize(static_cast<std::size_t>(bufferSize), 0.f);
+
+            previousOutput.resize(static_cast<std::size_t>(maximumBlockSize), 0.f);
+            currentOutput.resize(static_cast<std::size_t>(maximumBlockSize), 0.f);
+            fadeIn.resize(static_cast<std::size_t>(maximumBlockSize), 0.f);
+            fadeOut.resize(static_cast<std::size_t>(maximumBlockSize), 0.f);
+        }
+
+        //==============================================================================================================
+        /** Sets the room size and damping, both from 0 to 1, and the level of
+            the reflections, which is a linear gain.
+
+            The new taps are crossfaded with the old ones over the next block.
+        */
+        void setParameters(float roomSize, float damping, float level)
+        {
+            previousTaps = currentTaps;
+            isCrossfading = true;
+
+            // The room's dimensions, in metres, scale from a small room up
+            // to a large hall.
+            const std::array<float, 3> roomDimensions{
+                juce::jmap(roomSize, 3.f, 25.f),
+                juce::jmap(roomSize, 4.f, 35.f),
+                juce::jmap(roomSize, 2.5f, 12.f)
+            };
+
+            // The source and listener positions, as proportions of the room's
+            // dimensions.
+            const std::array<float, 3> source{ 0.35f, 0.7f, 0.55f };
+            const std::array<float, 3> listener{ 0.5f, 0.3f, 0.45f };
+
+            // How much of the sound is reflected by each wall.
+            const auto reflectivity = 0.9f - 0.5f * damping;
+
+            for (auto ear = 0; ear < numEars; ear++)
+            {
+                // The ears are either side of the listener. The centre "ear"
+                // is used for mono.
+                auto earPosition = listener;
+
+                for (auto axis = 0; axis < 3; axis++)
+                    earPosition[static_cast<std::size_t>(axis)] *= roomDimensions[static_cast<std::size_t>(axis)];
+
+                earPosition[0] += ear == leftEar ? -earOffset : ear == rightEar ? earOffset : 0.f;
+
+                calculateTaps(roomDimensions, source, earPosition, reflectivity, level,
+                              currentTaps[static_cast<std::size_t>(ear)]);
+            }
+        }
+
+        /** Clears the delay line. */
+        void reset()
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.f);
+            writeIndex = 0;
+        }
+
+        //==============================================================================================================
+        /** Writes the given channels, mixed to mono, to the delay line. This
+            should be called before addReflections() for the same block.
+        */
+        void pushInput(const float* const* channels, int numChannels, int numSamples)
+        {
+            jassert(numSamples <= maxBlockSize);
+            jassert(numChannels > 0);
+
+            const auto scale = 1.f / static_cast<float>(numChannels);
+
+            // Write in up to two spans either side of the end of the buffer.
+            for (auto start = 0; start < numSamples;)
+            {
+                const auto numSpanSamples = juce::jmin(numSamples - start, bufferSize - writeIndex);
+                auto* destination = buffer.data() + writeIndex;
+
+                juce::FloatVectorOperations::copyWithMultiply(destination, channels[0] + start, scale, numSpanSamples);
+
+                for (auto channel = 1; channel < numChannels; channel++)
+                    juce::FloatVectorOperations::addWithMultiply(destination, channels[channel] + start, scale, numSpanSamples);
+
+                start += numSpanSamples;
+                writeIndex = (writeIndex + numSpanSamples) & (bufferSize - 1);
+            }
+        }
+
+        /** Adds the reflections of the block most recently given to
+            pushInput() to the given channels.
+        */
+        void addReflections(float* const* channels, int numChannels, int numSamples)
+        {
+            jassert(numSamples <= maxBlockSize);
+            numChannels = juce::jmin(numChannels, maxChannels);
+
+            if (isCrossfading)
+            {
+                for (auto i = 0; i < numSamples; i++)
+                {
+                    fadeIn[static_cast<std::size_t>(i)] = static_cast<float>(i + 1) / static_cast<float>(numSamples);
+                    fadeOut[static_cast<std::size_t>(i)] = 1.f - fadeIn[static_cast<std::size_t>(i)];
+                }
+            }
+
+            for (auto channel = 0; channel < numChannels; channel++)
+            {
+                // With more than one channel, alternate channels are heard by
+                // the left and right ears.
+                const auto ear = numChannels == 1 ? centreEar : channel % 2;
+                auto* output = channels[channel];
+
+                if (! isCrossfading)
+                {
+                    addTaps(currentTaps[static_cast<std::size_t>(ear)], output, numSamples);
+                    continue;
+                }
+
+                juce::FloatVectorOperations::clear(previousOutput.data(), numSamples);
+                juce::FloatVectorOperations::clear(currentOutput.data(), numSamples);
+
+                addTaps(previousTaps[static_cast<std::size_t>(ear)], previousOutput.data(), numSamples);
+                addTaps(currentTaps[static_cast<std::size_t>(ear)], currentOutput.data(), numSamples);
+
+                juce::FloatVectorOperations::addWithMultiply(output, previousOutput.data(), fadeOut.data(), numSamples);
+                juce::FloatVectorOperations::addWithMultiply(output, currentOutput.data(), fadeIn.data(), numSamples);
+            }
+
+            isCrossfading = false;
+        }
+
+    private:
+        //==============================================================================================================
+        struct Tap
+        {
+            int delay = 0;
+            float gain = 0.f;
+        };
+
+        using Taps = std::array<Tap, numTaps>;
+
+        //==============================================================================================================
+        /** Calculates the taps heard at the given position, from the first and
+            second order image sources of the given source.
+        */
+        void calculateTaps(const std::array<float, 3>& roomDimensions, const std::array<float, 3>& source,
+                           const std::array<float, 3>& ear, float reflectivity, float level, Taps& taps) const
+        {
+            // The position of the source's image after the given number of
+            // reflections along an axis.
+            auto getImagePosition = [&](int axis, int reflections) {
+                const auto size = roomDimensions[static_cast<std::size_t>(axis)];
+                const auto position = source[static_cast<std::size_t>(axis)] * size;
+
+                return static_cast<float>(reflections) * size + (reflections % 2 == 0 ? position : size - position);
+            };
+
+            auto getDistance = [&](int x, int y, int z) {
+                const auto dx = getImagePosition(0, x) - ear[0];
+                const auto dy = getImagePosition(1, y) - ear[1];
+                const auto dz = getImagePosition(2, z) - ear[2];
+
+                return std::sqrt(dx * dx + dy * dy + dz * dz);
+            };
+
+            // The reflections are delayed relative to the direct sound,
+            // which is the dry signal.
+            const auto directDistance = getDistance(0, 0, 0);
+            const auto maxDelay = static_cast<int>(maxDelayTime * currentSampleRate);
+
+            auto numCalculatedTaps = 0;
+            auto totalEnergy = 0.f;
+
+            for (auto x = -2; x <= 2; x++)
+            {
+                for (auto y = -2; y <= 2; y++)
+                {
+                    for (auto z = -2; z <= 2; z++)
+                    {
+                        const auto order = std::abs(x) + std::abs(y) + std::abs(z);
+
+                        if (order == 0 || order > 2)
+                            continue;
+
+                        const auto distance = getDistance(x, y, z);
+                        auto& tap = taps[static_cast<std::size_t>(numCalculatedTaps++)];
+
+                        const auto delayTime = (distance - directDistance) / speedOfSound;
+                        tap.delay = juce::jlimit(0, maxDelay, juce::roundToInt(delayTime * currentSampleRate));
+                        tap.gain = std::pow(reflectivity, static_cast<float>(order)) * directDistance / distance;
+
+                        totalEnergy += tap.gain * tap.gain;
+                    }
+                }
+            }
+
+            jassert(numCalculatedTaps == numTaps);
+
+            // Normalise the taps so the room size and damping change the
+            // character of the reflections more than their level.
+            const auto scale = totalEnergy > 0.f ? level / std::sqrt(totalEnergy) : 0.f;
+
+            for (auto& tap : taps)
+                tap.gain *= scale;
+        }
+
+        /** Adds the given taps of the most recent block to the output. */
+        void addTaps(const Taps& taps, float* output, int numSamples) const
+        {
+            for (const auto& tap : taps)
+            {
+                if (tap.gain == 0.f)
+                    continue;
+
+                // The block started numSamples before the write index, so
+                // its delayed copy starts tap.delay samples before that.
+                const auto start = (writeIndex - numSamples - tap.delay) & (bufferSize - 1);
+                const auto numBeforeWrap = juce::jmin(numSamples, bufferSize - start);
+
+                juce::FloatVectorOperations::addWithMultiply(output, buffer.data() + start, tap.gain, numBeforeWrap);
+                juce::FloatVectorOperations::addWithMultiply(output + numBeforeWrap, buffer.data(), tap.gain,
+                                                             numSamples - numBeforeWrap);
+            }
+        }
+
+        //==============================================================================================================
+        static constexpr int leftEar = 0;
+        static constexpr int rightEar = 1;
+        static constexpr int centreEar = 2;
+        static constexpr int numEars = 3;
+
+        // Half the distance between the ears, in metres.
+        static constexpr float earOffset = 0.09f;
+
+        // In metres per second.
+        static constexpr float speedOfSound = 343.f;
+
+        const double currentSampleRate;
+        const int maxBlockSize;
+
+        std::vector<float> buffer;
+        int bufferSize = 0;
+        int writeIndex = 0;
+
+        std::array<Taps, numEars> currentTaps{};
+        std::array<Taps, numEars> previousTaps{};
+        bool isCrossfading = false;
+
+        // Scratch buffers used while crossfading.
+        std::vector<float> previousOutput;
+        std::vector<float> currentOutput;
+        std::vector<float> fadeIn;
+        std::vector<float> fadeOut;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EarlyReflections)
+    };
+}   // namespace contrast
@@ -40,6 +40,12 @@ namespace contrast
             return currentEnvelope;
         }
 
+        /** Resets the envelope to zero. */
+        void reset()
+        {
+            currentEnvelope = 0.f;
+        }
+
         /** Returns the most recently calculated envelope value. */
         float getCurrentEnvelope()
         {
@@ -54,7 +60,7 @@ namespace contrast
         */
         void setAttackTime(float newAttackTimeInMS)
         {
-            attack = std::exp(std::log(0.01f) / (newAttackTimeInMS * samplesPerMS));
+            attack = calculateCoefficient(newAttackTimeInMS, samplesPerMS);
         }
 
         /** Changes the time it takes for the envelope to response to the input
@@ -64,7 +70,16 @@ namespace contrast
         */
         void setReleaseTime(float newReleaseTimeInMS)
         {
-            release = std::exp(std::log(0.01f) / (newReleaseTimeInMS * samplesPerMS));
+            release = calculateCoefficient(newReleaseTimeInMS, samplesPerMS);
+        }
+
+        /** Returns the coefficient that eases an envelope to within 1% of its
+            target in the given time, for use by classes that follow several
+            envelopes at once.
+        */
+        static float calculateCoefficient(float timeInMS, float samplesPerMS)
+        {
+            return std::exp(std::log(0.01f) / (timeInMS * samplesPerMS));
         }
 
     private:
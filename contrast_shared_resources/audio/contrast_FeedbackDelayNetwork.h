@@ -0,0 +1,518 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** A reverb made from a feedback delay network (FDN).
+
+        The input is fed into either 8 or 16 delay lines of co-prime lengths
+        whose outputs are damped, attenuated according to the decay time and
+        mixed back into their inputs through a Householder matrix. The
+        Householder matrix mixes every line into every other line at the cost
+        of a single sum so it's much cheaper than a full matrix multiply, and
+        it's lossless so the decay time is set entirely by the line gains.
+
+        Rather than processing one sample at a time, audio is processed in
+        chunks no longer than the shortest delay line. Nothing written during
+        a chunk can be read back until the next chunk, so each line's output
+        can be read for the whole chunk up front and the matrix and gains can
+        be applied to the whole chunk with vectorised operations.
+
+        The parameters and mono/stereo interface match those of juce::Reverb
+        so the two can be swapped easily, but any number of channels up to
+        maxChannels can also be processed by the same network.
+    */
+    class FeedbackDelayNetwork
+    {
+    public:
+        //==============================================================================================================
+        FeedbackDelayNetwork(int numberOfLines, double sampleRate, int maximumBlockSize)
+            :   numLines(numberOfLines)
+        {
+            jassert(numLines == 8 || numLines == 16);
+            jassert(maximumBlockSize > 0);
+
+            // The delay lengths are chosen as prime numbers at 44.1kHz so the
+            // lines' resonances are spread as evenly as possible, and scaled
+            // for the current sample rate.
+            static constexpr int primeLengths[] = {
+                 743,  863, 1031, 1151, 1277, 1399, 1523, 1657,
+                1777, 1907, 2039, 2161, 2287, 2411, 2539, 2663
+            };
+
+            // With 8 lines, use every other length so the lines still cover
+            // the whole range.
+            const auto stride = 16 / numLines;
+            const auto sampleRateRatio = sampleRate / 44100.0;
+
+            for (auto line = 0; line < numLines; line++)
+            {
+                const auto length = juce::roundToInt(primeLengths[line * stride] * sampleRateRatio);
+                lines[static_cast<std::size_t>(line)].length = juce::jmax(1, length);
+            }
+
+            // Every line uses the same power-of-two buffer size so they can
+            // share a write index which can be wrapped with a mask.
+            auto longestLength = 0;
+            auto shortestLength = std::numeric_limits<int>::max();
+
+            for (auto line = 0; line < numLines; line++)
+            {
+                longestLength = juce::jmax(longestLength, lines[static_cast<std::size_t>(line)].length);
+                shortestLength = juce::jmin(shortestLength, lines[static_cast<std::size_t>(line)].length);
+            }
+
+            bufferSize = juce::nextPowerOfTwo(longestLength + 1);
+            buffers.resize(static_cast<std::size_t>(bufferSize * numLines), 0.f);
+
+            // The chunks can be no longer than half the shortest line since
+            // the extra taps used when there are more channels than lines are
+            // read from the middle of each line.
+            chunkSize = juce::jmax(1, juce::jmin(maximumBlockSize, shortestLength / 2));
+            lineOutputs.resize(static_cast<std::size_t>(chunkSize * numLines), 0.f);
+            transformBuffers.resize(static_cast<std::size_t>(chunkSize * numLines * 2), 0.f);
+            wetBuffers.resize(static_cast<std::size_t>(chunkSize * 2), 0.f);
+            sumBuffer.resize(static_cast<std::size_t>(chunkSize), 0.f);
+            inputBuffer.resize(static_cast<std::size_t>(chunkSize), 0.f);
+            dryGains.resize(static_cast<std::size_t>(chunkSize), 0.f);
+            ownWetGains.resize(static_cast<std::size_t>(chunkSize), 0.f);
+            otherWetGains.resize(static_cast<std::size_t>(chunkSize), 0.f);
+
+            currentSampleRate = sampleRate;
+            setParameters({});
+
+            // Resetting the smoothed values also jumps them straight to the
+            // initial parameters.
+            const auto smoothingTime = 0.01;
+            wetGains[0].reset(sampleRate, smoothingTime);
+            wetGains[1].reset(sampleRate, smoothingTime);
+            dryGain.reset(sampleRate, smoothingTime);
+        }
+
+        //==============================================================================================================
+        /** Sets the parameters of the reverb, which are interpreted the same
+            way as by juce::Reverb.
+        */
+        void setParameters(const juce::Reverb::Parameters& newParameters)
+        {
+            parameters = newParameters;
+
+            // juce::Reverb scales its wet and dry levels to make the most of
+            // the parameter ranges, so do the same here so both engines are
+            // about as loud as each other.
+            const auto wet = parameters.wetLevel * wetScaleFactor;
+            wetGains[0].setTargetValue(wet * (1.f + parameters.width) / 2.f);
+            wetGains[1].setTargetValue(wet * (1.f - parameters.width) / 2.f);
+            dryGain.setTargetValue(parameters.dryLevel * dryScaleFactor);
+
+            const auto frozen = parameters.freezeMode >= 0.5f;
+            inputGain = frozen ? 0.f : 1.f / std::sqrt(static_cast<float>(numLines));
+            damping = frozen ? 0.f : parameters.damping * maxDamping;
+
+            // Calculate the gain for each line that gives the decay time for
+            // the room size, based on how many times per second the signal
+            // passes through the line.
+            const auto decayTime = getDecayTime(parameters.roomSize);
+
+            for (auto line = 0; line < numLines; line++)
+            {
+                auto& state = lines[static_cast<std::size_t>(line)];
+                const auto lengthInSeconds = static_cast<float>(state.length / currentSampleRate);
+                state.gain = frozen ? 1.f : std::pow(10.f, -3.f * lengthInSeconds / decayTime);
+            }
+        }
+
+        /** Returns the time, in seconds, it takes the network's output to
+            decay by 60dB with the given room size, when it's not frozen.
+
+            Damping only shortens the decay of the higher frequencies so this
+            doesn't depend on it.
+        */
+        static float getDecayTime(float roomSize)
+        {
+            return minDecayTime * std::pow(maxDecayTime / minDecayTime, roomSize);
+        }
+
+        /** Returns the current parameters. */
+        const juce::Reverb::Parameters& getParameters() const
+        {
+            return parameters;
+        }
+
+        /** Clears the delay lines and damping filters. */
+        void reset()
+        {
+            std::fill(buffers.begin(), buffers.end(), 0.f);
+
+            for (auto& line : lines)
+                line.dampingState = 0.f;
+        }
+
+        //==============================================================================================================
+        /** Processes a mono signal in place. */
+        void processMono(float* samples, int numSamples)
+        {
+            process(&samples, 1, numSamples);
+        }
+
+        /** Processes a stereo signal in place. */
+        void processStereo(float* left, float* right, int numSamples)
+        {
+            float* channels[] = { left, right };
+            process(channels, 2, numSamples);
+        }
+
+        /** Processes any number of channels, up to maxChannels, in place.
+
+            Every channel is fed into, and taken from, the same network, with
+            each channel's output tapped from the lines using a different row
+            of a Hadamard matrix. The rows are orthogonal so the outputs are
+            decorrelated, but it costs barely more than a single stereo
+            reverb.
+
+            The width parameter is applied by mixing each channel's output with
+            the average of all the others, which for stereo is the same as
+            juce::Reverb.
+        */
+        void process(float* const* channels, int numChannels, int numSamples)
+        {
+            jassert(numChannels > 0 && numChannels <= maxChannels);
+            numChannels = juce::jmin(numChannels, maxChannels);
+
+            for (auto start = 0; start < numSamples; start += chunkSize)
+            {
+                const auto numChunkSamples = juce::jmin(chunkSize, numSamples - start);
+
+                // The network is fed with the average of every channel.
+                juce::FloatVectorOperations::copy(inputBuffer.data(), channels[0] + start, numChunkSamples);
+
+                for (auto channel = 1; channel < numChannels; channel++)
+                    juce::FloatVectorOperations::add(inputBuffer.data(), channels[channel] + start, numChunkSamples);
+
+                juce::FloatVectorOperations::multiply(inputBuffer.data(), 1.f / static_cast<float>(numChannels), numChunkSamples);
+
+                processChunk(numChannels, numChunkSamples);
+                applyMix(channels, numChannels, start, numChunkSamples);
+            }
+        }
+
+        //==============================================================================================================
+        /** The most channels that can be processed. */
+        static constexpr int maxChannels = 16;
+
+    private:
+        //==============================================================================================================
+        /** Runs the network for a chunk of no more than chunkSize samples,
+            taking its input from the input buffer and pointing each of the
+            wet outputs at that channel's decorrelated output.
+        */
+        void processChunk(int numChannels, int numSamples)
+        {
+            const auto mask = bufferSize - 1;
+
+            // Mono and stereo outputs are cheapest to tap directly from the
+            // lines. Beyond that, it's cheaper to calculate every row of the
+            // Hadamard matrix at once with a fast Walsh-Hadamard transform.
+            const auto useTransform = numChannels > 2;
+
+            // If there are more channels than lines there aren't enough rows
+            // to go round, so the rest of the channels are tapped from the
+            // middle of each line instead.
+            const auto useMiddleTaps = numChannels > numLines;
+
+            juce::FloatVectorOperations::clear(sumBuffer.data(), numSamples);
+
+            if (! useTransform)
+            {
+                for (auto channel = 0; channel < numChannels; channel++)
+                {
+                    juce::FloatVectorOperations::clear(getWetBuffer(channel), numSamples);
+                    wetOutputs[static_cast<std::size_t>(channel)] = getWetBuffer(channel);
+                }
+            }
+
+            for (auto line = 0; line < numLines; line++)
+            {
+                auto& state = lines[static_cast<std::size_t>(line)];
+                auto* output = getLineOutput(line);
+
+                // Read the line's output for the whole chunk. Since the chunk
+                // is no longer than the line, it was all written before this
+                // chunk started.
+                readFromLine(output, line, state.length, numSamples);
+
+                if (useMiddleTaps)
+                    readFromLine(getTransformBuffer(line + numLines), line, state.length / 2, numSamples);
+
+                // Tap the outputs using a different row of a Hadamard matrix
+                // for each output.
+                if (useTransform)
+                {
+                    juce::FloatVectorOperations::copy(getTransformBuffer(line), output, numSamples);
+                }
+                else
+                {
+                    for (auto channel = 0; channel < numChannels; channel++)
+                    {
+                        juce::FloatVectorOperations::addWithMultiply(getWetBuffer(channel), output,
+                                                                     getHadamardSign(getOutputRow(channel), line),
+                                                                     numSamples);
+                    }
+                }
+
+                // Apply the damping filter, which has to be done one sample at
+                // a time, then the line's gain.
+                for (auto i = 0; i < numSamples; i++)
+                {
+                    state.dampingState = output[i] + damping * (state.dampingState - output[i]);
+                    output[i] = state.dampingState;
+                }
+
+                juce::FloatVectorOperations::multiply(output, state.gain, numSamples);
+                juce::FloatVectorOperations::add(sumBuffer.data(), output, numSamples);
+            }
+
+            if (useTransform)
+            {
+                // After the transform, each buffer holds the lines combined
+                // using the corresponding row of the Hadamard matrix.
+                applyHadamardTransform(0, numSamples);
+
+                if (useMiddleTaps)
+                    applyHadamardTransform(numLines, numSamples);
+
+                for (auto channel = 0; channel < numChannels; channel++)
+                {
+                    const auto set = channel < numLines ? 0 : numLines;
+                    wetOutputs[static_cast<std::size_t>(channel)] = getTransformBuffer(set + getOutputRow(channel));
+                }
+            }
+
+            // Apply the Householder matrix, A = I - (2 / N) * 1 * 1^T, by
+            // subtracting a scaled sum of all the lines from each line, add the
+            // input and write the result back into the lines.
+            const auto householderScale = -2.f / static_cast<float>(numLines);
+
+            for (auto line = 0; line < numLines; line++)
+            {
+                auto* output = getLineOutput(line);
+
+                // Feed the input in with a pattern of signs so it isn't fed
+                // equally into every line, which the Householder matrix would
+                // just invert, and so it isn't the same as the first output
+                // taps.
+                const auto lineInputGain = inputGain * getHadamardSign(numLines - 1, line);
+
+                juce::FloatVectorOperations::addWithMultiply(output, sumBuffer.data(), householderScale, numSamples);
+                juce::FloatVectorOperations::addWithMultiply(output, inputBuffer.data(), lineInputGain, numSamples);
+
+                auto* buffer = buffers.data() + line * bufferSize;
+                const auto numBeforeWrap = juce::jmin(numSamples, bufferSize - writeIndex);
+                juce::FloatVectorOperations::copy(buffer + writeIndex, output, numBeforeWrap);
+                juce::FloatVectorOperations::copy(buffer, output + numBeforeWrap, numSamples - numBeforeWrap);
+            }
+
+            writeIndex = (writeIndex + numSamples) & mask;
+        }
+
+        /** Mixes the wet outputs with the dry input. */
+        void applyMix(float* const* channels, int numChannels, int start, int numSamples)
+        {
+            // Calculate the gains for every sample in the chunk up front so
+            // the mix itself can be vectorised for every channel.
+            fillGains(dryGain, dryGains.data(), numSamples);
+            fillGains(wetGains[0], ownWetGains.data(), numSamples);
+            fillGains(wetGains[1], otherWetGains.data(), numSamples);
+
+            const auto outputScale = outputGain / std::sqrt(static_cast<float>(numLines));
+
+            // Each channel's own output is mixed with the average of the other
+            // channels' outputs. That's the same as mixing it with the sum of
+            // every channel's output, minus itself, which saves summing the
+            // other channels separately for each channel.
+            if (numChannels > 1)
+            {
+                const auto otherScale = outputScale / static_cast<float>(numChannels - 1);
+
+                juce::FloatVectorOperations::multiply(otherWetGains.data(), otherScale, numSamples);
+                juce::FloatVectorOperations::multiply(ownWetGains.data(), outputScale, numSamples);
+                juce::FloatVectorOperations::subtract(ownWetGains.data(), otherWetGains.data(), numSamples);
+
+                juce::FloatVectorOperations::copy(sumBuffer.data(), wetOutputs[0], numSamples);
+
+                for (auto channel = 1; channel < numChannels; channel++)
+                    juce::FloatVectorOperations::add(sumBuffer.data(), wetOutputs[static_cast<std::size_t>(channel)], numSamples);
+            }
+            else
+            {
+                juce::FloatVectorOperations::multiply(ownWetGains.data(), outputScale, numSamples);
+            }
+
+            for (auto channel = 0; channel < numChannels; channel++)
+            {
+                auto* samples = channels[channel] + start;
+
+                juce::FloatVectorOperations::multiply(samples, dryGains.data(), numSamples);
+                juce::FloatVectorOperations::addWithMultiply(samples, wetOutputs[static_cast<std::size_t>(channel)],
+                                                             ownWetGains.data(), numSamples);
+
+                if (numChannels > 1)
+                    juce::FloatVectorOperations::addWithMultiply(samples, sumBuffer.data(), otherWetGains.data(), numSamples);
+            }
+        }
+
+        /** Fills the destination with the next values of the given smoothed
+            value.
+        */
+        static void fillGains(juce::SmoothedValue<float>& gain, float* destination, int numSamples)
+        {
+            if (! gain.isSmoothing())
+            {
+                juce::FloatVectorOperations::fill(destination, gain.getTargetValue(), numSamples);
+                return;
+            }
+
+            for (auto i = 0; i < numSamples; i++)
+                destination[i] = gain.getNextValue();
+        }
+
+        /** Applies an in-place fast Walsh-Hadamard transform across the
+            numLines transform buffers starting at the given index, for every
+            sample in the chunk.
+        */
+        void applyHadamardTransform(int firstBuffer, int numSamples)
+        {
+            for (auto halfSize = 1; halfSize < numLines; halfSize *= 2)
+            {
+                for (auto block = 0; block < numLines; block += halfSize * 2)
+                {
+                    for (auto i = block; i < block + halfSize; i++)
+                    {
+                        // Replace (a, b) with (a + b, a - b) without needing
+                        // another buffer: b becomes a - b, then a + b is
+                        // 2a - (a - b).
+                        auto* a = getTransformBuffer(firstBuffer + i);
+                        auto* b = getTransformBuffer(firstBuffer + i + halfSize);
+
+                        juce::FloatVectorOperations::subtract(b, a, b, numSamples);
+                        juce::FloatVectorOperations::multiply(a, 2.f, numSamples);
+                        juce::FloatVectorOperations::subtract(a, b, numSamples);
+                    }
+                }
+            }
+        }
+
+        /** Reads a chunk from the given line, starting the given number of
+            samples before the current write position.
+        */
+        void readFromLine(float* destination, int line, int delay, int numSamples) const
+        {
+            const auto* buffer = buffers.data() + line * bufferSize;
+            const auto start = (writeIndex + bufferSize - delay) & (bufferSize - 1);
+            const auto numBeforeWrap = juce::jmin(numSamples, bufferSize - start);
+
+            juce::FloatVectorOperations::copy(destination, buffer + start, numBeforeWrap);
+            juce::FloatVectorOperations::copy(destination + numBeforeWrap, buffer, numSamples - numBeforeWrap);
+        }
+
+        /** Returns the row of the Hadamard matrix used to tap the given
+            channel's output. Row 0 (all ones) is used last, so mono and stereo
+            use rows 1 and 2.
+        */
+        int getOutputRow(int channel) const
+        {
+            return (channel + 1) % numLines;
+        }
+
+        float* getLineOutput(int line)
+        {
+            return lineOutputs.data() + line * chunkSize;
+        }
+
+        float* getTransformBuffer(int index)
+        {
+            return transformBuffers.data() + index * chunkSize;
+        }
+
+        float* getWetBuffer(int channel)
+        {
+            return wetBuffers.data() + channel * chunkSize;
+        }
+
+        /** Returns the element of a Sylvester-Hadamard matrix at the given
+            row and column, which is either 1 or -1.
+        */
+        static float getHadamardSign(int row, int column)
+        {
+            auto bits = static_cast<unsigned int>(row & column);
+            auto parity = 0u;
+
+            for (; bits != 0; bits &= bits - 1)
+                parity ^= 1u;
+
+            return parity == 0 ? 1.f : -1.f;
+        }
+
+        //==============================================================================================================
+        // The same scale factors used by juce::Reverb.
+        static constexpr float wetScaleFactor = 3.f;
+        static constexpr float dryScaleFactor = 2.f;
+
+        // The range of decay times, in seconds, covered by the room size.
+        static constexpr float minDecayTime = 0.3f;
+        static constexpr float maxDecayTime = 12.f;
+
+        // The damping filter's coefficient at full damping.
+        static constexpr float maxDamping = 0.7f;
+
+        // Brings the network's output down to about the level of juce::Reverb.
+        static constexpr float outputGain = 0.25f;
+
+        // The most delay lines a network can have.
+        static constexpr int maxLines = 16;
+
+        //==============================================================================================================
+        struct Line
+        {
+            int length = 0;
+            float gain = 0.f;
+            float dampingState = 0.f;
+        };
+
+        const int numLines;
+        std::array<Line, maxLines> lines;
+
+        double currentSampleRate = 44100.0;
+        juce::Reverb::Parameters parameters;
+
+        // The delay lines, stored one after the other in a single buffer.
+        std::vector<float> buffers;
+        int bufferSize = 0;
+        int writeIndex = 0;
+
+        int chunkSize = 0;
+        float inputGain = 0.f;
+        float damping = 0.f;
+
+        juce::SmoothedValue<float> wetGains[2];
+        juce::SmoothedValue<float> dryGain;
+
+        // Scratch buffers, allocated up front so nothing needs allocating on
+        // the audio thread.
+        std::vector<float> lineOutputs;
+        std::vector<float> transformBuffers;
+        std::vector<float> wetBuffers;
+        std::vector<float> sumBuffer;
+        std::vector<float> inputBuffer;
+        std::vector<float> dryGains;
+        std::vector<float> ownWetGains;
+        std::vector<float> otherWetGains;
+
+        // Points to each channel's output for the current chunk.
+        std::array<const float*, maxChannels> wetOutputs{};
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FeedbackDelayNetwork)
+    };
+}   // namespace contrast
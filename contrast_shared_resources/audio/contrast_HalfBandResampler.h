@@ -0,0 +1,206 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Halves or doubles the sample rate of a single channel using a
+        polyphase half-band FIR filter.
+
+        Every other coefficient of a half-band filter is zero, apart from the
+        centre one, so splitting the filter into its two phases means each
+        output only costs half of the filter's taps. Stages can be chained to
+        reduce the rate by 4, 8 and so on.
+
+        A signal is downsampled, processed at the lower rate, then upsampled
+        again by the same resampler. Any block size can be used: an odd number
+        of samples leaves the downsampler half way through a pair, and the
+        upsampler queues one sample of its output so it always has enough to
+        fill the block.
+    */
+    class HalfBandResampler
+    {
+    public:
+        //==============================================================================================================
+        explicit HalfBandResampler(int maximumBlockSize)
+        {
+            // A Kaiser-windowed sinc. Every even offset from the centre is
+            // exactly zero and the centre is a half, which is what makes this
+            // a half-band filter.
+            const auto beta = 6.0;
+            const auto besselOfBeta = besselI0(beta);
+
+            std::array<double, numTaps> taps{};
+            auto sum = 0.0;
+
+            for (auto i = 0; i < numTaps; i++)
+            {
+                const auto offset = i - centreTap;
+                const auto x = static_cast<double>(offset) / centreTap;
+                const auto window = besselI0(beta * std::sqrt(1.0 - x * x)) / besselOfBeta;
+
+                if (offset == 0)
+                    taps[static_cast<std::size_t>(i)] = 0.5;
+                else if (offset % 2 == 0)
+                    taps[static_cast<std::size_t>(i)] = 0.0;
+                else
+                    taps[static_cast<std::size_t>(i)] = std::sin(juce::MathConstants<double>::halfPi * offset)
+                                                      / (juce::MathConstants<double>::pi * offset) * window;
+
+                sum += taps[static_cast<std::size_t>(i)];
+            }
+
+            // The centre tap is odd so the non-zero side taps all have even
+            // indices. Normalise so the filter has unity gain at DC.
+            for (auto i = 0; i < numSideTaps; i++)
+                sideTaps[static_cast<std::size_t>(i)] = static_cast<float>(taps[static_cast<std::size_t>(i * 2)] / sum);
+
+            centreGain = static_cast<float>(0.5 / sum);
+
+            upsampledQueue.resize(static_cast<std::size_t>(maximumBlockSize + 2), 0.f);
+            reset();
+        }
+
+        //==============================================================================================================
+        /** Clears the filters' states. */
+        void reset()
+        {
+            std::fill(downsamplerHistory.begin(), downsamplerHistory.end(), 0.f);
+            std::fill(upsamplerHistory.begin(), upsamplerHistory.end(), 0.f);
+            std::fill(upsampledQueue.begin(), upsampledQueue.end(), 0.f);
+
+            downsamplerIndex = 0;
+            upsamplerIndex = 0;
+            isHalfWay = false;
+
+            // Start with one sample queued so there's always enough output
+            // for the upsampler to fill a block.
+            numQueued = 1;
+        }
+
+        //==============================================================================================================
+        /** Downsamples the input, writing one output sample for every second
+            input sample, and returns the number of output samples written.
+        */
+        int downsample(const float* input, float* output, int numSamples)
+        {
+            auto numOutputSamples = 0;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                // The history is stored twice so the most recent numTaps
+                // samples can always be read contiguously.
+                downsamplerIndex = (downsamplerIndex + 1) % numTaps;
+                downsamplerHistory[static_cast<std::size_t>(downsamplerIndex)] = input[i];
+                downsamplerHistory[static_cast<std::size_t>(downsamplerIndex + numTaps)] = input[i];
+
+                isHalfWay = ! isHalfWay;
+
+                if (isHalfWay)
+                    continue;
+
+                // The newest sample is at the end of this window.
+                const auto* window = downsamplerHistory.data() + downsamplerIndex + 1;
+                auto sample = centreGain * window[numTaps - 1 - centreTap];
+
+                for (auto tap = 0; tap < numSideTaps; tap++)
+                    sample += sideTaps[static_cast<std::size_t>(tap)] * window[numTaps - 1 - tap * 2];
+
+                output[numOutputSamples++] = sample;
+            }
+
+            return numOutputSamples;
+        }
+
+        /** Upsamples the input, which should be the output of the last call
+            to downsample() after being processed, and writes numSamples
+            samples of output, which should be the number of samples given to
+            that call.
+        */
+        void upsample(const float* input, int numInputSamples, float* output, int numSamples)
+        {
+            for (auto i = 0; i < numInputSamples; i++)
+            {
+                upsamplerIndex = (upsamplerIndex + 1) % numUpsamplerTaps;
+                upsamplerHistory[static_cast<std::size_t>(upsamplerIndex)] = input[i];
+                upsamplerHistory[static_cast<std::size_t>(upsamplerIndex + numUpsamplerTaps)] = input[i];
+
+                const auto* window = upsamplerHistory.data() + upsamplerIndex + 1;
+
+                // Upsampling is the same as inserting a zero after every
+                // sample then filtering, with the gain doubled to make up
+                // for the zeros. The first of each pair of outputs uses the
+                // side taps, and the second only the centre tap.
+                auto sample = 0.f;
+
+                for (auto tap = 0; tap < numSideTaps; tap++)
+                    sample += sideTaps[static_cast<std::size_t>(tap)] * window[numUpsamplerTaps - 1 - tap];
+
+                upsampledQueue[static_cast<std::size_t>(numQueued++)] = 2.f * sample;
+                upsampledQueue[static_cast<std::size_t>(numQueued++)] = 2.f * centreGain
+                                                                      * window[numUpsamplerTaps - 1 - centreTap / 2];
+            }
+
+            jassert(numQueued >= numSamples);
+            numSamples = juce::jmin(numSamples, numQueued);
+
+            std::copy(upsampledQueue.begin(), upsampledQueue.begin() + numSamples, output);
+            std::copy(upsampledQueue.begin() + numSamples, upsampledQueue.begin() + numQueued, upsampledQueue.begin());
+            numQueued -= numSamples;
+        }
+
+        //==============================================================================================================
+        /** Returns the delay, in samples at the higher rate, added by
+            downsampling then upsampling.
+        */
+        static constexpr int getLatency()
+        {
+            return centreTap * 2;
+        }
+
+    private:
+        //==============================================================================================================
+        /** The zeroth-order modified Bessel function of the first kind, used
+            for the Kaiser window.
+        */
+        static double besselI0(double x)
+        {
+            auto sum = 1.0;
+            auto term = 1.0;
+
+            for (auto k = 1; k < 32; k++)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+
+            return sum;
+        }
+
+        //==============================================================================================================
+        // The filter has 47 taps, 24 of which are non-zero side taps.
+        static constexpr int centreTap = 23;
+        static constexpr int numTaps = centreTap * 2 + 1;
+        static constexpr int numSideTaps = centreTap + 1;
+
+        // The upsampler works at the lower rate so only needs every other
+        // sample of the history.
+        static constexpr int numUpsamplerTaps = numSideTaps;
+
+        std::array<float, numSideTaps> sideTaps{};
+        float centreGain = 0.5f;
+
+        std::array<float, numTaps * 2> downsamplerHistory{};
+        int downsamplerIndex = 0;
+        bool isHalfWay = false;
+
+        std::array<float, numUpsamplerTaps * 2> upsamplerHistory{};
+        int upsamplerIndex = 0;
+
+        std::vector<float> upsampledQueue;
+        int numQueued = 0;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HalfBandResampler)
+    };
+}   // namespace contrast
@@ -0,0 +1,121 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Keeps track of the spectra of the impulse responses loaded by every
+        plugin instance in the process, and caches them on disk.
+
+        Use a juce::SharedResourcePointer<ImpulseResponseCache> to access the
+        cache. Spectra are identified by a hash of the impulse response file's
+        contents, the sample rate and the convolver's partition sizes. When
+        spectra are requested, the cache checks, in order:
+        - Whether another instance is already using the same spectra, in
+          which case they're shared.
+        - Whether the spectra have been saved to disk before, in which case
+          the file is mapped into memory rather than read.
+        - Otherwise, the impulse response is loaded and its spectra are
+          calculated and saved to disk for next time.
+    */
+    class ImpulseResponseCache
+    {
+    public:
+        //==============================================================================================================
+        using Spectra = PartitionedConvolver::Spectra;
+
+        /** Loads an impulse response, at the given sample rate, from a file. */
+        using Loader = std::function<juce::AudioBuffer<float>(const juce::File&, double)>;
+
+        //==============================================================================================================
+        /** Returns the spectra for the given impulse response file at the
+            given sample rate, or nullptr if the file couldn't be loaded.
+
+            The loader is only called if the spectra aren't already in memory
+            or on disk. This shouldn't be called from the audio thread.
+        */
+        std::shared_ptr<const Spectra> getSpectra(const juce::File& file, double sampleRate, const Loader& loader)
+        {
+            const auto key = createKey(file, sampleRate);
+
+            if (key.isEmpty())
+                return nullptr;
+
+            {
+                const juce::ScopedLock lock(mutex);
+
+                if (auto spectra = spectraInUse[key].lock())
+                    return spectra;
+            }
+
+            const auto cacheFile = getCacheDirectory().getChildFile(key + ".bin");
+            auto spectra = Spectra::readFrom(cacheFile);
+
+            if (spectra == nullptr)
+            {
+                const auto impulseResponse = loader(file, sampleRate);
+
+                if (impulseResponse.getNumChannels() == 0 || impulseResponse.getNumSamples() == 0)
+                    return nullptr;
+
+                auto newSpectra = std::make_shared<const Spectra>(impulseResponse);
+
+                if (getCacheDirectory().createDirectory().wasOk())
+                    newSpectra->writeTo(cacheFile);
+
+                spectra = std::move(newSpectra);
+            }
+
+            const juce::ScopedLock lock(mutex);
+
+            // Another instance may have loaded the same spectra in the
+            // meantime, in which case use theirs so only one copy is kept.
+            if (auto existing = spectraInUse[key].lock())
+                return existing;
+
+            // Forget any spectra that are no longer used by any instance.
+            for (auto it = spectraInUse.begin(); it != spectraInUse.end();)
+                it = it->second.expired() ? spectraInUse.erase(it) : std::next(it);
+
+            spectraInUse[key] = spectra;
+            return spectra;
+        }
+
+        /** Returns the directory the spectra are cached in. */
+        static juce::File getCacheDirectory()
+        {
+            return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                .getChildFile("Contrast")
+                .getChildFile("ImpulseResponseCache");
+        }
+
+    private:
+        //==============================================================================================================
+        /** Returns the key identifying the spectra of the given file at the
+            given sample rate, or an empty string if the file can't be read.
+        */
+        static juce::String createKey(const juce::File& file, double sampleRate)
+        {
+            juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+
+            if (mappedFile.getData() == nullptr)
+                return {};
+
+            // 64-bit FNV-1a hash of the file's contents.
+            auto hash = static_cast<juce::uint64>(14695981039346656037ull);
+            const auto* bytes = static_cast<const juce::uint8*>(mappedFile.getData());
+
+            for (std::size_t i = 0; i < mappedFile.getSize(); i++)
+                hash = (hash ^ bytes[i]) * static_cast<juce::uint64>(1099511628211ull);
+
+            return juce::String::toHexString(static_cast<juce::int64>(hash))
+                 + "_" + juce::String(juce::roundToInt(sampleRate))
+                 + "_" + juce::String(PartitionedConvolver::headBlockSize)
+                 + "_" + juce::String(PartitionedConvolver::tailBlockSize);
+        }
+
+        //==============================================================================================================
+        juce::CriticalSection mutex;
+        std::map<juce::String, std::weak_ptr<const Spectra>> spectraInUse;
+    };
+}   // namespace contrast
@@ -0,0 +1,174 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Splits a signal into up to four bands using fourth-order
+        Linkwitz-Riley crossovers, so the bands sum back to a signal with the
+        same magnitude response as the input.
+
+        Rather than splitting the signal in a tree, each band has its own
+        chain of filters running in its own lane of a
+        juce::dsp::SIMDRegister, so every band is filtered at once for about
+        the cost of one. Each band is high-passed at the crossovers below it,
+        low-passed at the crossover directly above it, and all-passed at the
+        crossovers beyond that, which gives all the bands the same phase
+        response so they still sum flat.
+
+        The buffers used to split the signal are allocated up front for the
+        maximum block size given to the constructor, so this is safe to use on
+        the audio thread.
+    */
+    class LinkwitzRileyCrossover
+    {
+    public:
+        //==============================================================================================================
+        using Register = juce::dsp::SIMDRegister<float>;
+
+        // The number of bands is limited by the number of lanes in a
+        // register.
+        static constexpr int maxBands = 4;
+        static_assert(Register::size() >= static_cast<std::size_t>(maxBands));
+
+        //==============================================================================================================
+        LinkwitzRileyCrossover(double currentSampleRate, int maximumBlockSize)
+            :   sampleRate(currentSampleRate),
+                lanes(static_cast<std::size_t>(juce::jmax(1, maximumBlockSize)))
+        {
+        }
+
+        //==============================================================================================================
+        /** Sets the number of bands, and the frequencies they're split at.
+            There must be one less frequency than there are bands, in
+            ascending order.
+
+            The filters' states are kept so the crossovers can be moved while
+            the signal's running, but changing the number of bands resets
+            them.
+        */
+        void setCrossovers(int newNumBands, const float* frequencies)
+        {
+            jassert(newNumBands >= 1 && newNumBands <= maxBands);
+            newNumBands = juce::jlimit(1, maxBands, newNumBands);
+
+            if (newNumBands != numBands)
+                reset();
+
+            numBands = newNumBands;
+
+            // An all-pass is a single biquad, so the second biquad of an
+            // all-pass stage just passes the signal through.
+            const Biquad<Register>::Coefficients identity;
+
+            for (auto crossover = 0; crossover < numBands - 1; crossover++)
+            {
+                jassert(crossover == 0 || frequencies[crossover] >= frequencies[crossover - 1]);
+
+                const auto frequency = static_cast<double>(frequencies[crossover]);
+                const auto lowPass = Biquad<Register>::makeLowPass(sampleRate, frequency, butterworthQ);
+                const auto highPass = Biquad<Register>::makeHighPass(sampleRate, frequency, butterworthQ);
+                const auto allPass = Biquad<Register>::makeAllPass(sampleRate, frequency, butterworthQ);
+
+                auto& stage = stages[static_cast<std::size_t>(crossover)];
+
+                for (auto band = 0; band < maxBands; band++)
+                {
+                    const auto lane = static_cast<std::size_t>(band);
+
+                    if (band > crossover)
+                    {
+                        stage[0].setCoefficients(highPass, lane);
+                        stage[1].setCoefficients(highPass, lane);
+                    }
+                    else if (band == crossover)
+                    {
+                        stage[0].setCoefficients(lowPass, lane);
+                        stage[1].setCoefficients(lowPass, lane);
+                    }
+                    else
+                    {
+                        stage[0].setCoefficients(allPass, lane);
+                        stage[1].setCoefficients(identity, lane);
+                    }
+                }
+            }
+        }
+
+        /** Returns the number of bands the signal's split into. */
+        int getNumBands() const noexcept
+        {
+            return numBands;
+        }
+
+        /** Clears the filters' states. */
+        void reset()
+        {
+            for (auto& stage : stages)
+            {
+                for (auto& biquad : stage)
+                    biquad.reset();
+            }
+        }
+
+        //==============================================================================================================
+        /** Splits the given samples into bands, with each band in its own lane
+            of the output, starting from the lowest band in the first lane.
+            Any lanes beyond the number of bands should be ignored.
+        */
+        void process(const float* input, Register* bands, int numSamples)
+        {
+            for (auto i = 0; i < numSamples; i++)
+                bands[i] = Register::expand(input[i]);
+
+            // Only the crossovers in use are processed.
+            for (auto crossover = 0; crossover < numBands - 1; crossover++)
+            {
+                for (auto& biquad : stages[static_cast<std::size_t>(crossover)])
+                    biquad.process(bands, numSamples);
+            }
+        }
+
+        /** Splits the given samples into bands, with each band written to its
+            own buffer. There must be a buffer for each band.
+        */
+        void process(const float* input, float* const* bands, int numSamples)
+        {
+            const auto maxBlockSize = static_cast<int>(lanes.size());
+
+            for (auto start = 0; start < numSamples; start += maxBlockSize)
+            {
+                const auto blockSize = juce::jmin(maxBlockSize, numSamples - start);
+                process(input + start, lanes.data(), blockSize);
+
+                for (auto band = 0; band < numBands; band++)
+                {
+                    const auto lane = static_cast<std::size_t>(band);
+                    auto* output = bands[band] + start;
+
+                    for (auto i = 0; i < blockSize; i++)
+                        output[i] = lanes[static_cast<std::size_t>(i)].get(lane);
+                }
+            }
+        }
+
+    private:
+        //==============================================================================================================
+        // A fourth-order Linkwitz-Riley filter is two second-order Butterworth
+        // filters in series.
+        static constexpr double butterworthQ = 0.70710678118654752;
+
+        const double sampleRate;
+        int numBands = 1;
+
+        // The two biquads for each crossover.
+        std::array<std::array<Biquad<Register>, 2>, maxBands - 1> stages;
+
+        // Scratch space for the bands before they're split into separate
+        // buffers.
+        std::vector<Register> lanes;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinkwitzRileyCrossover)
+    };
+}   // namespace contrast
@@ -0,0 +1,880 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Convolves audio with an impulse response, with no latency, using
+        partitioned FFT convolution.
+
+        The impulse response is split into three parts:
+        - The first headBlockSize samples are convolved directly, one sample
+          at a time, so there's no latency.
+        - The rest of the first 2 * tailBlockSize samples (the head) is split
+          into headBlockSize partitions which are convolved using FFTs on the
+          audio thread each time a headBlockSize block of input is complete.
+        - Everything after that (the tail) is split into much larger
+          tailBlockSize partitions which are convolved by the shared
+          WorkerPool.
+
+        Since the tail doesn't start until 2 * tailBlockSize samples into the
+        impulse response, the pool has a whole tailBlockSize block of time to
+        finish each block before its output is needed, which is used as the
+        job's deadline. Blocks are handed to and from the pool through a small
+        ring of job slots guarded by atomics, so the audio thread never waits
+        for it. If the pool falls so far behind that the next slot is still
+        busy, that block is carried by the next job instead, so the tail's
+        blocks are always convolved in order and only the late output is
+        lost.
+
+        Larger partitions are much cheaper per sample, so using them for the
+        bulk of the impulse response keeps the cost of long impulse responses
+        low, while the small partitions at the start keep the latency at zero.
+
+        The spectra of the partitions are calculated once, up front, and are
+        never modified so they can be shared by any number of convolvers,
+        and saved to disk to avoid calculating them again. See Spectra.
+    */
+    class PartitionedConvolver  :   private WorkerPool::Client
+    {
+    public:
+        //==============================================================================================================
+        /** The size of the partitions convolved on the audio thread. */
+        static constexpr int headBlockSize = 64;
+
+        /** The size of the partitions convolved by the worker pool. */
+        static constexpr int tailBlockSize = 1024;
+
+        /** The longest impulse response that can be convolved: 20 seconds at
+            384kHz.
+        */
+        static constexpr int maxImpulseLength = 20 * 384000;
+
+        //==============================================================================================================
+        /** The precomputed, read-only data a convolver needs for an impulse
+            response: the reversed samples of its direct part, and the spectra
+            of its head and tail partitions.
+
+            The data is either calculated from an impulse response, or mapped
+            into memory from a file previously written by writeTo(), in which
+            case it's shared with every other process that maps the same file.
+        */
+        class Spectra
+        {
+        public:
+            //==========================================================================================================
+            /** Calculates the spectra of the given impulse response. */
+            explicit Spectra(const juce::AudioBuffer<float>& impulseResponse)
+                :   Spectra(impulseResponse.getNumChannels(), impulseResponse.getNumSamples())
+            {
+                ownedData.resize(getDataSize(), 0.f);
+                data = ownedData.data();
+
+                // Store the direct part of each impulse response channel in
+                // reverse so it can be applied as a dot product with the
+                // input history.
+                for (auto channel = 0; channel < numImpulseChannels; channel++)
+                {
+                    const auto* impulse = impulseResponse.getReadPointer(channel);
+                    auto* taps = ownedData.data() + channel * headBlockSize;
+
+                    for (auto i = 0; i < juce::jmin(headBlockSize, impulseLength); i++)
+                        taps[headBlockSize - 1 - i] = impulse[i];
+                }
+
+                calculatePartitionSpectra(impulseResponse, headBlockSize, headBlockSize, numHeadPartitions,
+                                          ownedData.data() + headOffset);
+                calculatePartitionSpectra(impulseResponse, 2 * tailBlockSize, tailBlockSize, numTailPartitions,
+                                          ownedData.data() + tailOffset);
+            }
+
+            //==========================================================================================================
+            /** Maps spectra previously written by writeTo() into memory.
+                Returns nullptr if the file doesn't exist or isn't valid.
+            */
+            static std::shared_ptr<const Spectra> readFrom(const juce::File& file)
+            {
+                auto mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+                if (mappedFile->getData() == nullptr || mappedFile->getSize() < sizeof(Header))
+                    return nullptr;
+
+                Header header;
+                std::memcpy(&header, mappedFile->getData(), sizeof(Header));
+
+                if (! header.isValid())
+                    return nullptr;
+
+                std::shared_ptr<Spectra> spectra(new Spectra(header.numChannels, header.impulseLength));
+
+                if (mappedFile->getSize() != sizeof(Header) + spectra->getDataSize() * sizeof(float))
+                    return nullptr;
+
+                spectra->data = reinterpret_cast<const float*>(static_cast<const char*>(mappedFile->getData())
+                                                               + sizeof(Header));
+                spectra->mappedFile = std::move(mappedFile);
+
+                return spectra;
+            }
+
+            /** Writes these spectra to the given file so they can be read back
+                with readFrom(). Returns true if successful.
+            */
+            bool writeTo(const juce::File& file) const
+            {
+                // Write to a temporary file first so that other instances
+                // never see a partially written file.
+                juce::TemporaryFile temporaryFile(file);
+
+                {
+                    juce::FileOutputStream stream(temporaryFile.getFile());
+
+                    if (stream.failedToOpen())
+                        return false;
+
+                    const auto header = Header::create(numImpulseChannels, impulseLength);
+
+                    if (! stream.write(&header, sizeof(Header))
+                        || ! stream.write(data, getDataSize() * sizeof(float)))
+                    {
+                        return false;
+                    }
+                }
+
+                return temporaryFile.overwriteTargetFileWithTemporary();
+            }
+
+            //==========================================================================================================
+            int getNumImpulseChannels() const
+            {
+                return numImpulseChannels;
+            }
+
+            int getImpulseLength() const
+            {
+                return impulseLength;
+            }
+
+            /** Returns the reversed direct part of the given channel. */
+            const float* getDirectTaps(int impulseChannel) const
+            {
+                return data + impulseChannel * headBlockSize;
+            }
+
+            /** Returns the spectra of the head partitions of every channel, one
+                channel after the other.
+            */
+            const float* getHeadSpectra() const
+            {
+                return data + headOffset;
+            }
+
+            int getNumHeadPartitions() const
+            {
+                return numHeadPartitions;
+            }
+
+            /** Returns the spectra of the tail partitions of every channel, one
+                channel after the other.
+            */
+            const float* getTailSpectra() const
+            {
+                return data + tailOffset;
+            }
+
+            int getNumTailPartitions() const
+            {
+                return numTailPartitions;
+            }
+
+        private:
+            //==========================================================================================================
+            /** Describes the contents of a spectra file. */
+            struct Header
+            {
+                static Header create(int numberOfChannels, int length)
+                {
+                    return { { 'C', 'I', 'R', 'S' }, version, headBlockSize, tailBlockSize, numberOfChannels, length };
+                }
+
+                bool isValid() const
+                {
+                    return std::memcmp(magic, "CIRS", 4) == 0
+                        && fileVersion == version
+                        && headSize == headBlockSize
+                        && tailSize == tailBlockSize
+                        && numChannels > 0
+                        && numChannels <= FeedbackDelayNetwork::maxChannels
+                        && impulseLength > 0
+                        && impulseLength <= maxImpulseLength;
+                }
+
+                static constexpr juce::int32 version = 1;
+
+                char magic[4];
+                juce::int32 fileVersion;
+                juce::int32 headSize;
+                juce::int32 tailSize;
+                juce::int32 numChannels;
+                juce::int32 impulseLength;
+            };
+
+            //==========================================================================================================
+            Spectra(int numberOfChannels, int length)
+                :   numImpulseChannels(numberOfChannels),
+                    impulseLength(length),
+                    numHeadPartitions(getNumPartitions(headBlockSize, headBlockSize, 2 * tailBlockSize, length)),
+                    numTailPartitions(getNumPartitions(2 * tailBlockSize, tailBlockSize, length, length)),
+                    headOffset(static_cast<std::size_t>(numberOfChannels) * headBlockSize),
+                    tailOffset(headOffset + getSpectraSize(numberOfChannels, numHeadPartitions, headBlockSize))
+            {
+                jassert(numImpulseChannels > 0 && numImpulseChannels <= FeedbackDelayNetwork::maxChannels);
+                jassert(impulseLength > 0 && impulseLength <= maxImpulseLength);
+            }
+
+            std::size_t getDataSize() const
+            {
+                return tailOffset + getSpectraSize(numImpulseChannels, numTailPartitions, tailBlockSize);
+            }
+
+            /** Returns the number of floats taken up by the spectra of the
+                given number of partitions of each channel. The sizes are
+                calculated in std::size_t, since a large enough impulse
+                response would overflow an int.
+            */
+            static std::size_t getSpectraSize(int numberOfChannels, int numPartitions, int partitionSize)
+            {
+                return static_cast<std::size_t>(numberOfChannels) * static_cast<std::size_t>(numPartitions)
+                     * static_cast<std::size_t>(2 * partitionSize + 2);
+            }
+
+            /** Returns the number of partitions of the given size needed to
+                cover the impulse response from the start offset up to the end
+                offset.
+            */
+            static int getNumPartitions(int startOffset, int partitionSize, int endOffset, int length)
+            {
+                const auto partitionedLength = juce::jmin(endOffset, length) - startOffset;
+                return partitionedLength > 0 ? (partitionedLength + partitionSize - 1) / partitionSize : 0;
+            }
+
+            /** Calculates the spectrum of every partition of every impulse
+                response channel, starting at the given offset.
+            */
+            static void calculatePartitionSpectra(const juce::AudioBuffer<float>& impulseResponse, int startOffset,
+                                                  int partitionSize, int numPartitions, float* destination)
+            {
+                if (numPartitions == 0)
+                    return;
+
+                juce::dsp::FFT fft(juce::roundToInt(std::log2(2.0 * partitionSize)));
+                const auto spectrumSize = fft.getSize() + 2;
+                std::vector<float> fftBuffer(static_cast<std::size_t>(fft.getSize() * 2), 0.f);
+
+                for (auto channel = 0; channel < impulseResponse.getNumChannels(); channel++)
+                {
+                    const auto* impulse = impulseResponse.getReadPointer(channel);
+
+                    for (auto partition = 0; partition < numPartitions; partition++)
+                    {
+                        const auto partitionStart = startOffset + partition * partitionSize;
+                        const auto partitionLength = juce::jmin(partitionSize, impulseResponse.getNumSamples() - partitionStart);
+
+                        std::fill(fftBuffer.begin(), fftBuffer.end(), 0.f);
+                        std::copy(impulse + partitionStart, impulse + partitionStart + partitionLength, fftBuffer.begin());
+                        fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+                        std::copy(fftBuffer.begin(), fftBuffer.begin() + spectrumSize,
+                                  destination + (channel * numPartitions + partition) * spectrumSize);
+                    }
+                }
+            }
+
+            //==========================================================================================================
+            const int numImpulseChannels;
+            const int impulseLength;
+            const int numHeadPartitions;
+            const int numTailPartitions;
+            const std::size_t headOffset;
+            const std::size_t tailOffset;
+
+            const float* data = nullptr;
+            std::vector<float> ownedData;
+            std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+
+            //==========================================================================================================
+            JUCE_DECLARE_NON_COPYABLE(Spectra)
+        };
+
+        //==============================================================================================================
+        /** Creates a convolver for the given impulse response, which should
+            already be at the given sample rate.
+
+            Each channel processed uses the impulse response channel with the
+            same index, wrapping around if there are more channels than the
+            impulse response has.
+        */
+        PartitionedConvolver(const juce::AudioBuffer<float>& impulseResponse, int numberOfChannels,
+                             double sampleRate)
+            :   PartitionedConvolver(std::make_shared<const Spectra>(impulseResponse), numberOfChannels, sampleRate)
+        {
+        }
+
+        /** Creates a convolver using precomputed spectra, which should have
+            been calculated from an impulse response at the given sample rate.
+        */
+        PartitionedConvolver(std::shared_ptr<const Spectra> spectraToUse, int numberOfChannels, double sampleRate)
+            :   spectra(std::move(spectraToUse)),
+                numChannels(numberOfChannels),
+                numImpulseChannels(spectra->getNumImpulseChannels()),
+                impulseLength(spectra->getImpulseLength()),
+                tailBlockDuration(1000.0 * tailBlockSize / sampleRate),
+                head(spectra->getHeadSpectra(), headBlockSize, spectra->getNumHeadPartitions(), numberOfChannels),
+                tail(spectra->getTailSpectra(), tailBlockSize, spectra->getNumTailPartitions(), numberOfChannels)
+        {
+            jassert(numChannels > 0);
+
+            // Each channel's history is stored twice, one copy after the
+            // other, so the most recent samples can always be read as a
+            // single contiguous block. It's long enough for a job carrying
+            // the most blocks.
+            historySize = juce::nextPowerOfTwo(getJobInputLength(maxBlocksPerJob));
+            histories.resize(static_cast<std::size_t>(numChannels * historySize * 2), 0.f);
+
+            headOutputs.resize(static_cast<std::size_t>(numChannels * headBlockSize), 0.f);
+            tailOutputs.resize(static_cast<std::size_t>(numChannels * tailBlockSize), 0.f);
+
+            if (tail.hasPartitions())
+            {
+                for (auto& slot : slots)
+                {
+                    slot.input.resize(static_cast<std::size_t>(numChannels * getJobInputLength(maxBlocksPerJob)), 0.f);
+                    slot.output.resize(static_cast<std::size_t>(numChannels * tailBlockSize), 0.f);
+                }
+
+                pool->addClient(*this);
+            }
+        }
+
+        ~PartitionedConvolver() override
+        {
+            pool->removeClient(*this);
+        }
+
+        //==============================================================================================================
+        /** Replaces the samples in the given channels with the result of
+            convolving them with the impulse response.
+        */
+        void process(float* const* channels, int numChannelsToProcess, int numSamples)
+        {
+            jassert(numChannelsToProcess <= numChannels);
+            numChannelsToProcess = juce::jmin(numChannelsToProcess, numChannels);
+
+            for (auto start = 0; start < numSamples;)
+            {
+                // Process up to the end of the current head block, at which
+                // point the head needs updating.
+                const auto numSegmentSamples = juce::jmin(numSamples - start, headBlockSize - headPosition);
+
+                for (auto channel = 0; channel < numChannelsToProcess; channel++)
+                    processSegment(channel, channels[channel] + start, numSegmentSamples);
+
+                start += numSegmentSamples;
+                headPosition += numSegmentSamples;
+                tailPosition += numSegmentSamples;
+                historyIndex = (historyIndex + numSegmentSamples) & (historySize - 1);
+
+                if (headPosition == headBlockSize)
+                {
+                    for (auto channel = 0; channel < numChannelsToProcess; channel++)
+                        head.process(channel, getImpulseChannel(channel), getRecentHistory(channel, 2 * headBlockSize), getHeadOutput(channel));
+
+                    headPosition = 0;
+                }
+
+                if (tailPosition == tailBlockSize)
+                {
+                    if (tail.hasPartitions())
+                    {
+                        collectTailJob();
+                        submitTailJob(numChannelsToProcess);
+                    }
+
+                    tailPosition = 0;
+                }
+            }
+        }
+
+        /** Clears the convolver's history so none of the input processed so
+            far is heard again. This should be called from the same thread as
+            process().
+
+            The tail's delay line belongs to the worker pool, so rather than
+            clearing it here, the next tail job clears it before it's used,
+            and the output of any jobs submitted before now is ignored.
+        */
+        void reset()
+        {
+            std::fill(histories.begin(), histories.end(), 0.f);
+            std::fill(headOutputs.begin(), headOutputs.end(), 0.f);
+            std::fill(tailOutputs.begin(), tailOutputs.end(), 0.f);
+            head.reset();
+
+            firstTailJobIndex = numTailJobsSubmitted;
+            numUnsubmittedTailBlocks = 0;
+            isTailClearNeeded = tail.hasPartitions();
+        }
+
+        //==============================================================================================================
+        /** Returns the length of the impulse response, in samples. */
+        int getImpulseLength() const
+        {
+            return impulseLength;
+        }
+
+        /** Returns the number of tail blocks that weren't finished by the
+            worker pool in time, which is useful for debugging.
+        */
+        int getNumMissedTailBlocks() const
+        {
+            return numMissedTailBlocks.load();
+        }
+
+    private:
+        //==============================================================================================================
+        /** Convolves part of an impulse response using uniform partitions and
+            overlap-save.
+
+            Each time a block of input is complete, its spectrum is added to a
+            frequency-domain delay line and multiplied by the spectrum of every
+            partition so each block only needs one forward and one inverse
+            FFT, however many partitions there are.
+        */
+        class UniformStage
+        {
+        public:
+            //==========================================================================================================
+            UniformStage(const float* spectra, int partitionSize, int numberOfPartitions, int numberOfChannels)
+                :   partitionSpectra(spectra),
+                    blockSize(partitionSize),
+                    numPartitions(numberOfPartitions),
+                    fft(juce::roundToInt(std::log2(2.0 * partitionSize)))
+            {
+                if (numPartitions == 0)
+                    return;
+
+                const auto fftSize = fft.getSize();
+                spectrumSize = fftSize + 2;
+
+                fftBuffer.resize(static_cast<std::size_t>(fftSize * 2), 0.f);
+                accumulator.resize(static_cast<std::size_t>(spectrumSize), 0.f);
+
+                delayLines.resize(static_cast<std::size_t>(numberOfChannels * numPartitions * spectrumSize), 0.f);
+                delayLineIndices.resize(static_cast<std::size_t>(numberOfChannels), 0);
+            }
+
+            //==========================================================================================================
+            bool hasPartitions() const
+            {
+                return numPartitions > 0;
+            }
+
+            /** Processes one block for the given channel. The input should be
+                the most recent 2 * blockSize samples, and blockSize samples
+                of output are written to the destination.
+            */
+            void process(int channel, int impulseChannel, const float* input, float* output)
+            {
+                if (numPartitions == 0)
+                {
+                    std::fill(output, output + blockSize, 0.f);
+                    return;
+                }
+
+                auto& delayLineIndex = delayLineIndices[static_cast<std::size_t>(channel)];
+                auto* delayLine = delayLines.data() + channel * numPartitions * spectrumSize;
+                const auto* spectra = partitionSpectra + impulseChannel * numPartitions * spectrumSize;
+
+                // Add the input's spectrum to the delay line.
+                std::copy(input, input + 2 * blockSize, fftBuffer.begin());
+                fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+                std::copy(fftBuffer.begin(), fftBuffer.begin() + spectrumSize, delayLine + delayLineIndex * spectrumSize);
+
+                // Multiply every partition by the input that's now reached it
+                // and sum the results.
+                std::fill(accumulator.begin(), accumulator.end(), 0.f);
+
+                for (auto partition = 0; partition < numPartitions; partition++)
+                {
+                    const auto inputIndex = (delayLineIndex + numPartitions - partition) % numPartitions;
+                    multiplyAndAccumulate(delayLine + inputIndex * spectrumSize, spectra + partition * spectrumSize);
+                }
+
+                delayLineIndex = (delayLineIndex + 1) % numPartitions;
+
+                // Only the second half of the result is free of wrap-around.
+                std::copy(accumulator.begin(), accumulator.end(), fftBuffer.begin());
+                fft.performRealOnlyInverseTransform(fftBuffer.data());
+                std::copy(fftBuffer.begin() + blockSize, fftBuffer.begin() + 2 * blockSize, output);
+            }
+
+            /** Adds the given number of silent blocks to the given channel's
+                delay line, in place of blocks whose input was lost, so the
+                partitions stay lined up with the input that follows.
+            */
+            void pushSilence(int channel, int numBlocks)
+            {
+                if (numPartitions == 0)
+                    return;
+
+                auto& delayLineIndex = delayLineIndices[static_cast<std::size_t>(channel)];
+                auto* delayLine = delayLines.data() + channel * numPartitions * spectrumSize;
+
+                for (auto block = 0; block < numBlocks; block++)
+                {
+                    std::fill(delayLine + delayLineIndex * spectrumSize, delayLine + (delayLineIndex + 1) * spectrumSize, 0.f);
+                    delayLineIndex = (delayLineIndex + 1) % numPartitions;
+
+                    // Once the whole delay line is silent, the remaining
+                    // blocks only need to move the index along.
+                    if (block + 1 == numPartitions)
+                    {
+                        delayLineIndex = (delayLineIndex + numBlocks - numPartitions) % numPartitions;
+                        break;
+                    }
+                }
+            }
+
+            /** Clears the delay line of every channel. This must only be called
+                from the thread that processes this stage.
+            */
+            void reset()
+            {
+                std::fill(delayLines.begin(), delayLines.end(), 0.f);
+                std::fill(delayLineIndices.begin(), delayLineIndices.end(), 0);
+            }
+
+        private:
+            //==========================================================================================================
+            /** Adds the product of the two interleaved complex spectra to the
+                accumulator.
+            */
+            void multiplyAndAccumulate(const float* a, const float* b)
+            {
+                auto* result = accumulator.data();
+
+                for (auto i = 0; i < spectrumSize; i += 2)
+                {
+                    result[i]     += a[i] * b[i]     - a[i + 1] * b[i + 1];
+                    result[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+                }
+            }
+
+            //==========================================================================================================
+            const float* partitionSpectra;
+            const int blockSize;
+            const int numPartitions;
+            juce::dsp::FFT fft;
+            int spectrumSize = 0;
+
+            std::vector<float> delayLines;
+            std::vector<int> delayLineIndices;
+
+            std::vector<float> fftBuffer;
+            std::vector<float> accumulator;
+
+            //==========================================================================================================
+            JUCE_DECLARE_NON_COPYABLE(UniformStage)
+        };
+
+        //==============================================================================================================
+        /** A block of input handed to the worker pool, and the output it
+            calculates from it.
+        */
+        struct TailJob
+        {
+            enum State
+            {
+                idle,
+                pending,
+                finished
+            };
+
+            std::atomic<int> state{ idle };
+            juce::int64 index = 0;
+            double deadline = 0.0;
+            int numChannels = 0;
+
+            // The number of consecutive blocks of input the job carries. Only
+            // the last one's output is used, the others are blocks that
+            // couldn't be submitted on time but still need convolving so the
+            // tail's delay line stays in order.
+            int numBlocks = 1;
+
+            // The number of blocks, before the ones carried, that were lost
+            // altogether.
+            int numLostBlocks = 0;
+
+            std::vector<float> input;
+            std::vector<float> output;
+        };
+
+        //==============================================================================================================
+        /** Writes a segment of the given channel to its history, then
+            replaces it with the convolved output.
+        */
+        void processSegment(int channel, float* samples, int numSamples)
+        {
+            auto* history = getHistory(channel);
+            const auto* taps = getDirectTaps(getImpulseChannel(channel));
+            const auto* headOutput = getHeadOutput(channel) + headPosition;
+            const auto* tailOutput = getTailOutput(channel) + tailPosition;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                const auto writeIndex = (historyIndex + i) & (historySize - 1);
+                history[writeIndex] = samples[i];
+                history[writeIndex + historySize] = samples[i];
+
+                // The direct part is a dot product of the reversed taps with
+                // the most recent headBlockSize samples, including this one.
+                const auto* recent = history + writeIndex + historySize + 1 - headBlockSize;
+                auto direct = 0.f;
+
+                for (auto tap = 0; tap < headBlockSize; tap++)
+                    direct += taps[tap] * recent[tap];
+
+                samples[i] = direct + headOutput[i] + tailOutput[i];
+            }
+        }
+
+        /** Takes the output of the previous tail job, which is needed for the
+            tail block that's about to start.
+        */
+        void collectTailJob()
+        {
+            const auto index = numTailJobsSubmitted - 1;
+            auto* job = findJob(index);
+
+            // Nothing has been submitted since the convolver was created or
+            // reset, so the tail is silent.
+            if (index < firstTailJobIndex)
+            {
+                std::fill(tailOutputs.begin(), tailOutputs.end(), 0.f);
+                return;
+            }
+
+            if (job == nullptr || job->state.load(std::memory_order_acquire) != TailJob::finished)
+            {
+                // The pool didn't finish in time so the tail will have a gap.
+                std::fill(tailOutputs.begin(), tailOutputs.end(), 0.f);
+                numMissedTailBlocks++;
+                return;
+            }
+
+            const auto numJobChannels = job->numChannels;
+            std::copy(job->output.begin(), job->output.begin() + numJobChannels * tailBlockSize, tailOutputs.begin());
+            job->state.store(TailJob::idle, std::memory_order_release);
+        }
+
+        /** Hands the most recent 2 * tailBlockSize samples of input to the
+            worker pool, along with the input of any blocks that couldn't be
+            handed over before.
+        */
+        void submitTailJob(int numChannelsToProcess)
+        {
+            auto& job = slots[static_cast<std::size_t>(numTailJobsSubmitted % numSlots)];
+
+            // If the pool is still busy with this slot it's falling behind,
+            // so this block's output won't be ready in time. Rather than wait,
+            // leave the block for the next job to carry.
+            if (job.state.load(std::memory_order_acquire) == TailJob::pending)
+            {
+                numUnsubmittedTailBlocks++;
+                numTailJobsSubmitted++;
+                return;
+            }
+
+            // Blocks too old to still be in the history are replaced with
+            // silence.
+            job.numBlocks = 1 + juce::jmin(numUnsubmittedTailBlocks, maxBlocksPerJob - 1);
+            job.numLostBlocks = numUnsubmittedTailBlocks + 1 - job.numBlocks;
+            numUnsubmittedTailBlocks = 0;
+
+            // After a reset, losing a whole delay line's worth of blocks
+            // clears out the input from before.
+            if (isTailClearNeeded)
+            {
+                job.numLostBlocks = juce::jmax(job.numLostBlocks, spectra->getNumTailPartitions());
+                isTailClearNeeded = false;
+            }
+
+            const auto inputLength = getJobInputLength(job.numBlocks);
+
+            for (auto channel = 0; channel < numChannelsToProcess; channel++)
+            {
+                const auto* recent = getRecentHistory(channel, inputLength);
+                std::copy(recent, recent + inputLength, job.input.begin() + channel * getJobInputLength(maxBlocksPerJob));
+            }
+
+            // The output is needed when the next tail block starts.
+            job.index = numTailJobsSubmitted++;
+            job.deadline = juce::Time::getMillisecondCounterHiRes() + tailBlockDuration;
+            job.numChannels = numChannelsToProcess;
+            job.state.store(TailJob::pending, std::memory_order_release);
+
+            pool->notify();
+        }
+
+        /** Returns the oldest pending tail job, or nullptr if there isn't
+            one.
+        */
+        TailJob* findOldestPendingJob()
+        {
+            TailJob* oldest = nullptr;
+
+            for (auto& job : slots)
+            {
+                if (job.state.load(std::memory_order_acquire) == TailJob::pending
+                    && (oldest == nullptr || job.index < oldest->index))
+                {
+                    oldest = &job;
+                }
+            }
+
+            return oldest;
+        }
+
+        //==============================================================================================================
+        std::optional<double> getNextDeadline() override
+        {
+            if (const auto* job = findOldestPendingJob())
+                return job->deadline;
+
+            return std::nullopt;
+        }
+
+        /** Processes the oldest pending tail job. This is called from the
+            worker pool.
+        */
+        void runNextJob() override
+        {
+            auto* oldest = findOldestPendingJob();
+
+            if (oldest == nullptr)
+                return;
+
+            // Convolve every block carried, oldest first, so each one reaches
+            // the tail's delay line in order. Each block's output overwrites
+            // the last, leaving the newest.
+            for (auto channel = 0; channel < oldest->numChannels; channel++)
+            {
+                const auto* input = oldest->input.data() + channel * getJobInputLength(maxBlocksPerJob);
+                auto* output = oldest->output.data() + channel * tailBlockSize;
+
+                tail.pushSilence(channel, oldest->numLostBlocks);
+
+                for (auto block = 0; block < oldest->numBlocks; block++)
+                    tail.process(channel, getImpulseChannel(channel), input + block * tailBlockSize, output);
+            }
+
+            oldest->state.store(TailJob::finished, std::memory_order_release);
+        }
+
+        WorkerPool::Priority getPriority() const override
+        {
+            // The tail is needed in real time.
+            return WorkerPool::Priority::high;
+        }
+
+        /** Returns the job slot with the given index, or nullptr if it's been
+            reused.
+        */
+        TailJob* findJob(juce::int64 index)
+        {
+            if (index < 0)
+                return nullptr;
+
+            auto& job = slots[static_cast<std::size_t>(index % numSlots)];
+            return job.index == index ? &job : nullptr;
+        }
+
+        /** Returns the number of samples of input a job needs to convolve the
+            given number of consecutive blocks.
+        */
+        static constexpr int getJobInputLength(int numBlocks)
+        {
+            return (numBlocks + 1) * tailBlockSize;
+        }
+
+        //==============================================================================================================
+        int getImpulseChannel(int channel) const
+        {
+            return channel % numImpulseChannels;
+        }
+
+        const float* getDirectTaps(int impulseChannel) const
+        {
+            return spectra->getDirectTaps(impulseChannel);
+        }
+
+        float* getHistory(int channel)
+        {
+            return histories.data() + channel * historySize * 2;
+        }
+
+        /** Returns the most recent samples of the given channel's history, as
+            a contiguous block.
+        */
+        const float* getRecentHistory(int channel, int numSamples)
+        {
+            return getHistory(channel) + historyIndex + historySize - numSamples;
+        }
+
+        float* getHeadOutput(int channel)
+        {
+            return headOutputs.data() + channel * headBlockSize;
+        }
+
+        float* getTailOutput(int channel)
+        {
+            return tailOutputs.data() + channel * tailBlockSize;
+        }
+
+        //==============================================================================================================
+        static constexpr int numSlots = 3;
+
+        // The most blocks a single job can carry.
+        static constexpr int maxBlocksPerJob = 8;
+
+        const std::shared_ptr<const Spectra> spectra;
+        const int numChannels;
+        const int numImpulseChannels;
+        const int impulseLength;
+        const double tailBlockDuration;
+
+        UniformStage head;
+        UniformStage tail;
+
+        std::vector<float> histories;
+        int historySize = 0;
+        int historyIndex = 0;
+
+        std::vector<float> headOutputs;
+        std::vector<float> tailOutputs;
+        int headPosition = 0;
+        int tailPosition = 0;
+
+        std::array<TailJob, numSlots> slots;
+        juce::int64 numTailJobsSubmitted = 0;
+        juce::int64 firstTailJobIndex = 0;
+        int numUnsubmittedTailBlocks = 0;
+        bool isTailClearNeeded = false;
+        std::atomic<int> numMissedTailBlocks{ 0 };
+
+        juce::SharedResourcePointer<WorkerPool> pool;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+    };
+}   // namespace contrast
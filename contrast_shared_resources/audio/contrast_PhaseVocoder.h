@@ -0,0 +1,466 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Changes the pitch of an audio signal in the frequency domain.
+
+        Each channel's input is split into overlapping, Hann-windowed frames
+        which are transformed with juce::dsp::FFT. The spectral peaks of each
+        frame are moved to their new frequencies along with the bins around
+        them, with the phases of those bins locked to their peak's phase
+        (Laroche & Dolson's "identity phase locking") to avoid the phasiness
+        of a plain phase vocoder. The frames are then transformed back and
+        overlap-added to form the output.
+
+        Unlike PitchShifter, which creates one object per channel, a single
+        PhaseVocoder processes every channel. All the channels' frames are
+        processed together, sharing the same FFT objects and scratch buffers.
+
+        Without a shift, the FFTs are skipped and the windowed frames are
+        overlap-added unchanged, so the output is just the delayed input.
+
+        Everything is allocated in the constructor (for the largest supported
+        FFT size) so the FFT size can be changed without allocating.
+    */
+    class PhaseVocoder
+    {
+    public:
+        //==============================================================================================================
+        // The range of supported FFT orders (i.e. FFT sizes of 512 to 4096).
+        static constexpr int minFFTOrder = 9;
+        static constexpr int maxFFTOrder = 12;
+
+        //==============================================================================================================
+        PhaseVocoder(int numChannels, int initialFFTOrder)
+        {
+            jassert(numChannels >= 0);
+
+            const auto maxSize = static_cast<std::size_t>(1 << maxFFTOrder);
+            const auto maxNumBins = maxSize / 2 + 1;
+
+            for (auto order = minFFTOrder; order <= maxFFTOrder; order++)
+            {
+                ffts.push_back(std::make_unique<juce::dsp::FFT>(order));
+
+                // Use a periodic Hann window so the overlapping windows sum
+                // to a constant.
+                const auto size = static_cast<std::size_t>(1 << order);
+                std::vector<float> window(size);
+
+                for (std::size_t i = 0; i < size; i++)
+                {
+                    const auto phase = juce::MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(size);
+                    window[i] = 0.5f - 0.5f * std::cos(phase);
+                }
+
+                windows.push_back(std::move(window));
+            }
+
+            fftBuffer      .resize(maxSize * 2, 0.f);
+            magnitudes     .resize(maxNumBins, 0.f);
+            phases         .resize(maxNumBins, 0.f);
+            frequencies    .resize(maxNumBins, 0.f);
+            peaks          .resize(maxNumBins, 0);
+            shiftedMagnitudes.resize(maxNumBins, 0.f);
+            shiftedPhases  .resize(maxNumBins, 0.f);
+
+            channels.resize(static_cast<std::size_t>(numChannels));
+
+            for (auto& channel : channels)
+            {
+                channel.inputFifo      .resize(maxSize, 0.f);
+                channel.outputFifo     .resize(maxSize, 0.f);
+                channel.dryFifo        .resize(maxSize, 0.f);
+                channel.accumulator    .resize(maxSize * 2, 0.f);
+                channel.lastPhases     .resize(maxNumBins, 0.f);
+                channel.synthesisPhases.resize(maxNumBins, 0.f);
+            }
+
+            setFFTOrder(initialFFTOrder);
+        }
+
+        //==============================================================================================================
+        /** Processes the given channels in place.
+
+            The number of channels must be no more than the number given to
+            the constructor.
+        */
+        void process(float* const* channelData, int numChannels, int numSamples)
+        {
+            jassert(static_cast<std::size_t>(numChannels) <= channels.size());
+
+            // Each frame is processed once the last hop of its input has
+            // arrived, then filling the FIFOs starts again from that hop.
+            const auto hopStart = fftSize - hopSize;
+            auto position = 0;
+
+            while (position < numSamples)
+            {
+                // Process as many samples as we can before the next frame is
+                // due.
+                const auto numToProcess = juce::jmin(numSamples - position, fftSize - fifoIndex);
+                const auto outputIndex = fifoIndex - hopStart;
+
+                for (auto channel = 0; channel < numChannels; channel++)
+                {
+                    auto& state = channels[static_cast<std::size_t>(channel)];
+                    auto samples = channelData[channel] + position;
+
+                    juce::FloatVectorOperations::copy(state.inputFifo.data() + fifoIndex, samples, numToProcess);
+
+                    // The dry signal is delayed by the same amount as the
+                    // wet signal so the two line up.
+                    juce::FloatVectorOperations::copyWithMultiply(samples, state.dryFifo.data() + outputIndex,
+                                                                  dryMix, numToProcess);
+                    juce::FloatVectorOperations::addWithMultiply(samples, state.outputFifo.data() + outputIndex,
+                                                                 wetMix, numToProcess);
+                }
+
+                fifoIndex += numToProcess;
+                position += numToProcess;
+
+                // Process the next frame for every channel in one batch.
+                if (fifoIndex == fftSize)
+                {
+                    for (auto channel = 0; channel < numChannels; channel++)
+                        processFrame(channels[static_cast<std::size_t>(channel)]);
+
+                    fifoIndex = hopStart;
+                }
+            }
+        }
+
+        /** Clears the state of all channels. */
+        void reset()
+        {
+            for (auto& channel : channels)
+            {
+                std::fill(channel.inputFifo.begin(), channel.inputFifo.end(), 0.f);
+                std::fill(channel.outputFifo.begin(), channel.outputFifo.end(), 0.f);
+                std::fill(channel.dryFifo.begin(), channel.dryFifo.end(), 0.f);
+                std::fill(channel.accumulator.begin(), channel.accumulator.end(), 0.f);
+                std::fill(channel.lastPhases.begin(), channel.lastPhases.end(), 0.f);
+                std::fill(channel.synthesisPhases.begin(), channel.synthesisPhases.end(), 0.f);
+                channel.hasSynthesisPhases = true;
+            }
+
+            fifoIndex = fftSize - hopSize;
+        }
+
+        //==============================================================================================================
+        /** Changes the size of the FFT used. The size is 2 to the power of the
+            given order. Larger sizes give a better frequency resolution (and so
+            better quality for tonal material) but add more latency.
+
+            Changing the order resets the processing state.
+        */
+        void setFFTOrder(int newOrder)
+        {
+            jassert(newOrder >= minFFTOrder && newOrder <= maxFFTOrder);
+            newOrder = juce::jlimit(minFFTOrder, maxFFTOrder, newOrder);
+
+            if (newOrder == fftOrder)
+                return;
+
+            fftOrder = newOrder;
+            fftSize = 1 << fftOrder;
+            hopSize = fftSize / overlap;
+
+            reset();
+        }
+
+        /** Returns the order of the FFT currently in use. */
+        int getFFTOrder() const
+        {
+            return fftOrder;
+        }
+
+        /** Returns the latency, in samples, introduced by the effect. */
+        int getLatency() const
+        {
+            // The first hop of each frame's output is only complete once the
+            // frame's whole input has arrived, and is then played over the
+            // next hop.
+            return fftSize;
+        }
+
+        /** Sets the frequency shift of the pitch shifter.
+            This is essentially the number by which the frequency content of
+            the sound will be multiplied, so a shift of 2 will result in the
+            sound being an octave higher.
+        */
+        void setShift(float newShift)
+        {
+            jassert(newShift > 0.f);
+            shift = newShift;
+        }
+
+        /** Sets the amount of shift in frequency to use, in semitones and
+            cents.
+        */
+        void setShift(int semitones, float cents)
+        {
+            setShift(std::pow(2.f, (static_cast<float>(semitones) + cents / 100.f) / 12.f));
+        }
+
+        /** Sets the dry/wet mix for the effect.
+            Value must be 0 - 1 where 0 is dry and 1 is wet.
+        */
+        void setMix(float newMix)
+        {
+            jassert(newMix >= 0.f && newMix <= 1.f);
+
+            // Use the same sqrt law as PitchShifter so both engines have the
+            // same loudness at a given mix.
+            wetMix = std::sqrt(newMix);
+            dryMix = std::sqrt(1.f - newMix);
+        }
+
+    private:
+        //==============================================================================================================
+        struct ChannelState
+        {
+            // The most recent fftSize samples of input.
+            std::vector<float> inputFifo;
+
+            // The next hop of output, ready to be read.
+            std::vector<float> outputFifo;
+
+            // The input that lines up with the output FIFO, for the dry
+            // signal.
+            std::vector<float> dryFifo;
+
+            // The overlap-added output of the frames processed so far.
+            std::vector<float> accumulator;
+
+            // The phases of each bin from the previous analysis frame.
+            std::vector<float> lastPhases;
+
+            // The phases of each bin from the previous synthesis frame, which
+            // are only valid if that frame was shifted.
+            std::vector<float> synthesisPhases;
+            bool hasSynthesisPhases = true;
+        };
+
+        //==============================================================================================================
+        /** Analyses the given channel's input FIFO, shifts it, and adds the
+            result to the channel's accumulator.
+        */
+        void processFrame(ChannelState& state)
+        {
+            const auto& window = windows[static_cast<std::size_t>(fftOrder - minFFTOrder)];
+
+            // Window the input and, unless there's no shift to apply, shift
+            // it in the frequency domain. Without a shift the windowed frame
+            // is overlap-added as it is, which gives back the input delayed
+            // by the latency.
+            juce::FloatVectorOperations::multiply(fftBuffer.data(), state.inputFifo.data(), window.data(), fftSize);
+
+            if (shift == 1.f)
+                state.hasSynthesisPhases = false;
+            else
+                shiftFrame(state);
+
+            // Window the frame again and overlap-add it to the output. The sum
+            // of the squared Hann windows is 1.5 for an overlap of 4.
+            juce::FloatVectorOperations::multiply(fftBuffer.data(), window.data(), fftSize);
+            juce::FloatVectorOperations::addWithMultiply(state.accumulator.data(), fftBuffer.data(), 1.f / 1.5f, fftSize);
+
+            // The first hop of the accumulator is now complete so move it to
+            // the output FIFO and shift everything else along.
+            juce::FloatVectorOperations::copy(state.outputFifo.data(), state.accumulator.data(), hopSize);
+            std::copy(state.accumulator.begin() + hopSize, state.accumulator.begin() + hopSize + fftSize,
+                      state.accumulator.begin());
+            juce::FloatVectorOperations::clear(state.accumulator.data() + fftSize, hopSize);
+
+            // Keep the hop of input that matches the output FIFO for the dry
+            // signal, then shift the input along to make space for the next
+            // hop.
+            juce::FloatVectorOperations::copy(state.dryFifo.data(), state.inputFifo.data(), hopSize);
+            std::copy(state.inputFifo.begin() + hopSize, state.inputFifo.begin() + fftSize, state.inputFifo.begin());
+        }
+
+        /** Shifts the windowed frame in the FFT buffer, in place. */
+        void shiftFrame(ChannelState& state)
+        {
+            const auto& fft = *ffts[static_cast<std::size_t>(fftOrder - minFFTOrder)];
+            const auto numBins = fftSize / 2 + 1;
+
+            fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+            analyse(state, numBins);
+            const auto numPeaks = findPeaks(numBins);
+            shiftPeaks(state, numBins, numPeaks);
+
+            // Convert the shifted spectrum back to the time domain.
+            for (auto bin = 0; bin < numBins; bin++)
+            {
+                const auto magnitude = shiftedMagnitudes[static_cast<std::size_t>(bin)];
+                const auto phase = shiftedPhases[static_cast<std::size_t>(bin)];
+
+                fftBuffer[static_cast<std::size_t>(bin * 2)] = magnitude * std::cos(phase);
+                fftBuffer[static_cast<std::size_t>(bin * 2 + 1)] = magnitude * std::sin(phase);
+            }
+
+            fftBuffer[1] = 0.f;
+            fftBuffer[static_cast<std::size_t>(fftSize + 1)] = 0.f;
+            fft.performRealOnlyInverseTransform(fftBuffer.data());
+        }
+
+        /** Calculates the magnitude, phase, and true frequency of each bin in
+            the FFT buffer.
+        */
+        void analyse(ChannelState& state, int numBins)
+        {
+            // The amount a bin's phase is expected to advance by between frames
+            // if its frequency were exactly the bin's centre frequency.
+            const auto expectedAdvance = juce::MathConstants<float>::twoPi * static_cast<float>(hopSize) / static_cast<float>(fftSize);
+
+            for (auto bin = 0; bin < numBins; bin++)
+            {
+                const auto index = static_cast<std::size_t>(bin);
+                const auto real = fftBuffer[index * 2];
+                const auto imaginary = fftBuffer[index * 2 + 1];
+
+                magnitudes[index] = std::sqrt(real * real + imaginary * imaginary);
+                phases[index] = std::atan2(imaginary, real);
+
+                // The difference between the actual and expected phase advance
+                // tells us how far the bin's true frequency is from its centre
+                // frequency.
+                const auto binAdvance = static_cast<float>(bin) * expectedAdvance;
+                const auto deviation = wrapPhase(phases[index] - state.lastPhases[index] - binAdvance);
+                state.lastPhases[index] = phases[index];
+
+                // Stored as the phase advance per hop.
+                frequencies[index] = binAdvance + deviation;
+            }
+        }
+
+        /** Finds the bins that are local maxima, storing their indices in the
+            peaks buffer and returning the number found.
+        */
+        int findPeaks(int numBins)
+        {
+            auto numPeaks = 0;
+
+            for (auto bin = 2; bin < numBins - 2; bin++)
+            {
+                const auto magnitude = magnitudes[static_cast<std::size_t>(bin)];
+
+                if (magnitude > magnitudes[static_cast<std::size_t>(bin - 1)]
+                    && magnitude > magnitudes[static_cast<std::size_t>(bin - 2)]
+                    && magnitude >= magnitudes[static_cast<std::size_t>(bin + 1)]
+                    && magnitude >= magnitudes[static_cast<std::size_t>(bin + 2)]
+                    && magnitude > 1.0e-6f)
+                {
+                    peaks[static_cast<std::size_t>(numPeaks++)] = bin;
+                }
+            }
+
+            return numPeaks;
+        }
+
+        /** Moves each peak, and the region of bins around it, to its shifted
+            frequency, locking the phases of the region to the peak's phase.
+        */
+        void shiftPeaks(ChannelState& state, int numBins, int numPeaks)
+        {
+            std::fill(shiftedMagnitudes.begin(), shiftedMagnitudes.begin() + numBins, 0.f);
+            std::fill(shiftedPhases.begin(), shiftedPhases.begin() + numBins, 0.f);
+
+            for (auto i = 0; i < numPeaks; i++)
+            {
+                const auto peak = peaks[static_cast<std::size_t>(i)];
+                const auto shiftedPeak = juce::roundToInt(static_cast<float>(peak) * shift);
+
+                if (shiftedPeak >= numBins)
+                    break;
+
+                // Each peak's region of influence extends half way to its
+                // neighbouring peaks.
+                const auto regionStart = i == 0 ? 0 : (peaks[static_cast<std::size_t>(i - 1)] + peak + 1) / 2;
+                const auto regionEnd = i == numPeaks - 1 ? numBins : (peak + peaks[static_cast<std::size_t>(i + 1)] + 1) / 2;
+
+                // The peak's new phase continues on from the previous frame's
+                // phase at its new position, advancing at its shifted
+                // frequency. If the previous frame wasn't shifted, there's
+                // nothing to continue from, so the analysed phase is used.
+                const auto peakPhase = state.hasSynthesisPhases
+                                     ? wrapPhase(state.synthesisPhases[static_cast<std::size_t>(shiftedPeak)]
+                                                 + frequencies[static_cast<std::size_t>(peak)] * shift)
+                                     : phases[static_cast<std::size_t>(peak)];
+                const auto offset = shiftedPeak - peak;
+
+                for (auto bin = regionStart; bin < regionEnd; bin++)
+                {
+                    const auto destination = bin + offset;
+
+                    if (destination < 0 || destination >= numBins)
+                        continue;
+
+                    const auto magnitude = magnitudes[static_cast<std::size_t>(bin)];
+                    auto& shiftedMagnitude = shiftedMagnitudes[static_cast<std::size_t>(destination)];
+
+                    // Regions can overlap once shifted, in which case the
+                    // phase is taken from whichever bin is loudest. Otherwise,
+                    // keep the phase relationship between this bin and the
+                    // peak the same as it was in the analysis frame.
+                    if (magnitude > shiftedMagnitude)
+                    {
+                        shiftedPhases[static_cast<std::size_t>(destination)] = peakPhase
+                                                                               + phases[static_cast<std::size_t>(bin)]
+                                                                               - phases[static_cast<std::size_t>(peak)];
+                    }
+
+                    shiftedMagnitude += magnitude;
+                }
+            }
+
+            std::copy(shiftedPhases.begin(), shiftedPhases.begin() + numBins, state.synthesisPhases.begin());
+            state.hasSynthesisPhases = true;
+        }
+
+        /** Wraps the given phase to the range -pi to pi. */
+        static float wrapPhase(float phase)
+        {
+            return phase - juce::MathConstants<float>::twoPi * std::round(phase / juce::MathConstants<float>::twoPi);
+        }
+
+        //==============================================================================================================
+        // The number of frames that overlap at any one time.
+        static constexpr int overlap = 4;
+
+        // One FFT object and window for each supported order, shared by all
+        // channels.
+        std::vector<std::unique_ptr<juce::dsp::FFT>> ffts;
+        std::vector<std::vector<float>> windows;
+
+        int fftOrder = 0;
+        int fftSize = 0;
+        int hopSize = 0;
+
+        // The position in the FIFOs, shared by all channels.
+        int fifoIndex = 0;
+
+        // Scratch buffers shared by all channels.
+        std::vector<float> fftBuffer;
+        std::vector<float> magnitudes;
+        std::vector<float> phases;
+        std::vector<float> frequencies;
+        std::vector<int> peaks;
+        std::vector<float> shiftedMagnitudes;
+        std::vector<float> shiftedPhases;
+
+        std::vector<ChannelState> channels;
+
+        float shift = 1.f;
+        float wetMix = 1.f;
+        float dryMix = 0.f;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PhaseVocoder)
+    };
+}   // namespace contrast
@@ -8,62 +8,79 @@ namespace contrast
 
         This implementation is shamelessly stolen from The STK:
         https://github.com/thestk/stk/blob/master/include/PitShift.h
+
+        Both of the STK's delay lines always hold the same input, so here they
+        are replaced by a single history buffer that two read heads move
+        through. Audio is best processed a block at a time using process(),
+        which calculates the read-head trajectories and crossfade envelopes
+        for the whole block before reading from the history.
+
+        Up to maxVoices voices, each with their own shift and gain, can be
+        read from the same history, which makes a cheap harmoniser. All of
+        the voices' read heads are evaluated together in a single pass over
+        the block. When none of the voices are shifting, the heads stay put
+        and are read as fixed taps instead.
+
+        The history is allocated for the maximum delay given to the
+        constructor, so the window can then be shortened (and lengthened
+        again) with setWindowLength() without allocating.
     */
     class PitchShifter
     {
     public:
+        //==============================================================================================================
+        /** The most voices a single PitchShifter can produce. */
+        static constexpr int maxVoices = 4;
+
         //==============================================================================================================
         PitchShifter(const int maximumDelay, double sampleRate, juce::uint32 blockSize)
-            :   maxDelay(static_cast<float>(maximumDelay))
+            :   maxDelay(maximumDelay),
+                maxBlockSize(static_cast<int>(blockSize))
         {
+            juce::ignoreUnused(sampleRate);
+            jassert(maxBlockSize > 0);
+
+            jassert(maximumDelay >= minWindowLength);
+
             delayLength = maximumDelay - 24;
             halfLength = delayLength / 2;
-            delay[0] = 12.f;
-            delay[1] = maxDelay / 2.f;
-
-            for (int i = 0; i < 2; i++)
-            {
-                delayLine[i].reset(new juce::dsp::DelayLine<float>(maximumDelay));
-                delayLine[i]->prepare({ sampleRate, blockSize, 1 });
-                delayLine[i]->setDelay(delay[0]);
-            }
-        }
 
-        //==============================================================================================================
-        float processSample(float input)
-        {
-            // Update the delay lengths and clamp them between the valid range.
-            delay[0] += rate;
-            delay[1] = delay[0] + halfLength;
+            for (auto& voice : voices)
+                voice.delay = 12.f;
 
-            for (int i = 0; i < 2; i++)
-            {
-                while (delay[i] > maxDelay - 12.f)
-                    delay[i] -= delayLength;
-                while (delay[i] < 12.f)
-                    delay[i] += delayLength;
+            // The history needs to hold the longest delay plus a whole block
+            // since a block's input is written before any of it is read.
+            // Using a power-of-two size means indices can be wrapped with a
+            // mask rather than a branch.
+            historySize = juce::nextPowerOfTwo(maximumDelay + maxBlockSize + 2);
+            history.resize(static_cast<std::size_t>(historySize), 0.f);
 
-                // Set the new delay line length.
-                delayLine[i]->setDelay(delay[i]);
-            }
+            for (auto& trajectory : trajectories)
+                trajectory.resize(static_cast<std::size_t>(maxBlockSize), 0.f);
 
-            // Calculate a triangular envelope.
-            envelope[1] = std::abs((delay[0] - halfLength + 12.f) * (1.f / (halfLength + 12.f)));
-            envelope[0] = 1.f - envelope[1];
+            for (auto& envelope : envelopes)
+                envelope.resize(static_cast<std::size_t>(maxBlockSize), 0.f);
 
-            // Delay the input.
-            delayLine[0]->pushSample(0, input);
-            delayLine[1]->pushSample(0, input);
+            wetBuffer.resize(static_cast<std::size_t>(maxBlockSize), 0.f);
+        }
 
-            // Get the delayed signal and apply the envelope.
-            auto output = envelope[0] * delayLine[0]->popSample(0);
-            output += envelope[1] * delayLine[1]->popSample(0);
+        //==============================================================================================================
+        /** Processes a single sample.
 
-            // Apply the mix.
-            output *= wetMix;
-            output += dryMix * input;
+            This is equivalent to calling process() with a block of one sample
+            so it's much slower per sample than processing whole blocks.
+        */
+        float processSample(float input)
+        {
+            process(&input, 1);
+            return input;
+        }
 
-            return output;
+        /** Processes the given samples in place. */
+        void process(float* samples, int numSamples)
+        {
+            for (auto start = 0; start < numSamples; start += maxBlockSize)
+                processChunk(samples + start, juce::jmin(maxBlockSize, numSamples - start));
         }
 
         //==============================================================================================================
@@ -71,16 +88,12 @@ namespace contrast
             This is essentially the number by which the frequency content of
             the sound will be multiplied, so a shift of 2 will result in the
             sound being an octave higher.
+
+            This sets the shift of the first voice.
         */
         void setShift(float shift)
         {
-            if (shift != 0.f)
-                rate = 1.f - shift;
-            else
-            {
-                rate = 0.f;
-                delay[0] = static_cast<float>(halfLength) + 12.f;
-            }
+            setVoiceShift(0, shift);
         }
 
         /** Sets the amount of shift in frequency to use.
@@ -90,7 +103,66 @@ namespace contrast
         */
         void setShift(int semitones, float cents)
         {
-            setShift(std::pow(std::pow(2.f, 1.f / 12.f), semitones + cents / 100.f));
+            setVoiceShift(0, semitones, cents);
+        }
+
+        /** Sets the frequency shift of the given voice. */
+        void setVoiceShift(int voiceIndex, float shift)
+        {
+            jassert(juce::isPositiveAndBelow(voiceIndex, maxVoices));
+            auto& voice = voices[static_cast<std::size_t>(voiceIndex)];
+
+            if (shift != 0.f)
+                voice.rate = 1.f - shift;
+            else
+            {
+                voice.rate = 0.f;
+                voice.delay = static_cast<float>(halfLength) + 12.f;
+            }
+        }
+
+        /** Sets the frequency shift of the given voice in semitones and
+            cents.
+        */
+        void setVoiceShift(int voiceIndex, int semitones, float cents)
+        {
+            setVoiceShift(voiceIndex, std::pow(std::pow(2.f, 1.f / 12.f), semitones + cents / 100.f));
+        }
+
+        /** Sets the linear gain applied to the given voice. */
+        void setVoiceGain(int voiceIndex, float gain)
+        {
+            jassert(juce::isPositiveAndBelow(voiceIndex, maxVoices));
+            voices[static_cast<std::size_t>(voiceIndex)].gain = gain;
+        }
+
+        /** Sets the number of voices to produce, from 1 to maxVoices. */
+        void setNumVoices(int newNumVoices)
+        {
+            jassert(newNumVoices >= 1 && newNumVoices <= maxVoices);
+            numVoices = juce::jlimit(1, maxVoices, newNumVoices);
+        }
+
+        /** Sets the length of the window, in samples, which is limited to the
+            maximum delay given to the constructor. Longer windows give
+            smoother results at the cost of more latency.
+
+            This never allocates so is safe to call from the audio thread.
+        */
+        void setWindowLength(int newWindowLength)
+        {
+            const auto newDelayLength = juce::jlimit(minWindowLength, maxDelay, newWindowLength) - 24;
+
+            if (newDelayLength == delayLength)
+                return;
+
+            delayLength = newDelayLength;
+            halfLength = delayLength / 2;
+
+            // Move any read heads that are now outside the window back into
+            // it.
+            for (auto& voice : voices)
+                voice.delay = wrapDelay(voice.delay);
         }
 
         /** Returns the current length of the delay being applied by this
@@ -117,15 +189,245 @@ namespace contrast
 
     private:
         //==============================================================================================================
-        std::unique_ptr<juce::dsp::DelayLine<float>> delayLine[2];
+        /** Processes a chunk of no more than maxBlockSize samples. */
+        void processChunk(float* samples, int numSamples)
+        {
+            // Without a shift, a voice's read heads never move, so there's no
+            // need to calculate their trajectories and envelopes. The same
+            // goes for a shift so close to 1 that the heads would move by less
+            // than the smallest step a delay can take over the whole chunk.
+            const auto minMovingRate = (static_cast<float>(delayLength) + 12.f) * std::numeric_limits<float>::epsilon()
+                                     / static_cast<float>(numSamples);
+            const auto areHeadsStationary = std::all_of(voices.begin(), voices.begin() + numVoices,
+                                                        [minMovingRate](const Voice& voice) {
+                                                            return std::abs(voice.rate) < minMovingRate;
+                                                        });
+
+            if (!areHeadsStationary)
+                calculateHeads(numSamples);
+
+            // Write the whole chunk to the history before reading from it.
+            // The shortest delay is 12 samples so nothing in this chunk will
+            // be read before it's been written.
+            const auto firstWriteIndex = writeIndex;
+            const auto numBeforeWrap = juce::jmin(numSamples, historySize - writeIndex);
+            juce::FloatVectorOperations::copy(history.data() + writeIndex, samples, numBeforeWrap);
+            juce::FloatVectorOperations::copy(history.data(), samples + numBeforeWrap, numSamples - numBeforeWrap);
+            writeIndex = (writeIndex + numSamples) & (historySize - 1);
+
+            // Read every voice's heads from the history, applying their
+            // envelopes.
+            if (areHeadsStationary)
+                readStationaryHeads(firstWriteIndex, numSamples);
+            else
+                readHeads(numVoices * 2, firstWriteIndex, numSamples);
+
+            // Apply the mix.
+            juce::FloatVectorOperations::multiply(samples, dryMix, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(samples, wetBuffer.data(), wetMix, numSamples);
+        }
+
+        /** Calculates the trajectories and crossfade envelopes of every
+            voice's read heads for the next chunk.
+        */
+        void calculateHeads(int numSamples)
+        {
+            for (std::size_t voiceIndex = 0; voiceIndex < static_cast<std::size_t>(numVoices); voiceIndex++)
+            {
+                auto& voice = voices[voiceIndex];
+                auto& firstTrajectory = trajectories[voiceIndex * 2];
+                auto& secondTrajectory = trajectories[voiceIndex * 2 + 1];
+                auto& firstEnvelope = envelopes[voiceIndex * 2];
+                auto& secondEnvelope = envelopes[voiceIndex * 2 + 1];
+
+                // Calculate where both of the voice's read heads will be for
+                // every sample in the chunk. The second head is always half
+                // the delay length behind the first.
+                fillWrappedRamp(firstTrajectory.data(), numSamples, voice.delay, voice.rate);
+                fillWrappedRamp(secondTrajectory.data(), numSamples, voice.delay + static_cast<float>(halfLength), voice.rate);
+                voice.delay = firstTrajectory[static_cast<std::size_t>(numSamples - 1)];
+
+                // Calculate the triangular crossfade envelopes from the first
+                // head's trajectory, scaled by the voice's gain.
+                juce::FloatVectorOperations::copy(secondEnvelope.data(), firstTrajectory.data(), numSamples);
+                juce::FloatVectorOperations::add(secondEnvelope.data(), 12.f - static_cast<float>(halfLength), numSamples);
+                juce::FloatVectorOperations::multiply(secondEnvelope.data(), 1.f / (static_cast<float>(halfLength) + 12.f), numSamples);
+                juce::FloatVectorOperations::abs(secondEnvelope.data(), secondEnvelope.data(), numSamples);
+                juce::FloatVectorOperations::negate(firstEnvelope.data(), secondEnvelope.data(), numSamples);
+                juce::FloatVectorOperations::add(firstEnvelope.data(), 1.f, numSamples);
+                juce::FloatVectorOperations::multiply(firstEnvelope.data(), voice.gain, numSamples);
+                juce::FloatVectorOperations::multiply(secondEnvelope.data(), voice.gain, numSamples);
+            }
+        }
+
+        /** Fills the wet buffer with the sum of the given number of read
+            heads, in a single pass over the chunk.
+        */
+        void readHeads(int numHeads, int firstWriteIndex, int numSamples)
+        {
+            const auto mask = historySize - 1;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                const auto sampleIndex = static_cast<std::size_t>(i);
+                auto wet = 0.f;
+
+                for (std::size_t head = 0; head < static_cast<std::size_t>(numHeads); head++)
+                {
+                    // Find the sample that was written 'delay' samples before
+                    // this one and linearly interpolate between it and the
+                    // sample before it.
+                    const auto delay = trajectories[head][sampleIndex];
+                    const auto wholeDelay = static_cast<int>(delay);
+                    const auto fraction = delay - static_cast<float>(wholeDelay);
+                    const auto index = (firstWriteIndex + i + historySize - wholeDelay) & mask;
+
+                    const auto newer = history[static_cast<std::size_t>(index)];
+                    const auto older = history[static_cast<std::size_t>((index + mask) & mask)];
+
+                    wet += envelopes[head][sampleIndex] * (newer + fraction * (older - newer));
+                }
+
+                wetBuffer[sampleIndex] = wet;
+            }
+        }
+
+        /** Fills the wet buffer when none of the voices are shifting, so each
+            read head keeps the same delay and envelope for the whole chunk.
+            Each head is then just a fixed pair of taps on the history, which
+            are added a span at a time.
+        */
+        void readStationaryHeads(int firstWriteIndex, int numSamples)
+        {
+            const auto half = static_cast<float>(halfLength);
+
+            juce::FloatVectorOperations::clear(wetBuffer.data(), numSamples);
+
+            for (std::size_t voiceIndex = 0; voiceIndex < static_cast<std::size_t>(numVoices); voiceIndex++)
+            {
+                auto& voice = voices[voiceIndex];
+                voice.delay = wrapDelay(voice.delay);
+
+                // The same triangular crossfade as calculateHeads().
+                const auto secondGain = std::abs((voice.delay + 12.f - half) / (half + 12.f));
+
+                addStationaryHead(firstWriteIndex, numSamples, voice.delay, voice.gain * (1.f - secondGain));
+                addStationaryHead(firstWriteIndex, numSamples, wrapDelay(voice.delay + half), voice.gain * secondGain);
+            }
+        }
+
+        /** Adds a read head with a fixed delay and gain to the wet buffer,
+            linearly interpolating between the two samples either side of the
+            delay.
+        */
+        void addStationaryHead(int firstWriteIndex, int numSamples, float delay, float gain)
+        {
+            const auto wholeDelay = static_cast<int>(delay);
+            const auto fraction = delay - static_cast<float>(wholeDelay);
+            const auto index = (firstWriteIndex + historySize - wholeDelay) & (historySize - 1);
+
+            addFromHistory(index, numSamples, gain * (1.f - fraction));
+            addFromHistory((index + historySize - 1) & (historySize - 1), numSamples, gain * fraction);
+        }
+
+        /** Adds the history, from the given index onwards, to the wet buffer
+            with the given gain.
+        */
+        void addFromHistory(int startIndex, int numSamples, float gain)
+        {
+            const auto numBeforeWrap = juce::jmin(numSamples, historySize - startIndex);
+
+            juce::FloatVectorOperations::addWithMultiply(wetBuffer.data(), history.data() + startIndex, gain, numBeforeWrap);
+            juce::FloatVectorOperations::addWithMultiply(wetBuffer.data() + numBeforeWrap, history.data(), gain,
+                                                         numSamples - numBeforeWrap);
+        }
+
+        /** Fills the destination with a ramp that starts one increment after
+            the given start value and is wrapped around to stay within the
+            valid range of delay values.
+
+            Rather than checking whether every value needs wrapping, the
+            number of values before the ramp next leaves the valid range is
+            calculated up front so each segment between wrap points is just a
+            plain ramp.
+        */
+        void fillWrappedRamp(float* destination, int numSamples, float start, float increment) const
+        {
+            const auto lower = 12.f;
+            const auto upper = static_cast<float>(delayLength) + 12.f;
+
+            auto value = wrapDelay(start);
+            auto i = 0;
+
+            while (i < numSamples)
+            {
+                auto segmentLength = numSamples - i;
+
+                // The distance to the next wrap point is limited in floating
+                // point first, since with a tiny increment it could be far
+                // too large for an int.
+                if (increment > 0.f)
+                    segmentLength = static_cast<int>(juce::jmin(static_cast<float>(segmentLength), (upper - value) / increment));
+                else if (increment < 0.f)
+                    segmentLength = static_cast<int>(juce::jmin(static_cast<float>(segmentLength), (value - lower) / -increment));
+
+                for (auto j = 0; j < segmentLength; j++)
+                    destination[i + j] = value + static_cast<float>(j + 1) * increment;
+
+                i += segmentLength;
+
+                if (segmentLength > 0)
+                    value = destination[i - 1];
+
+                // The next value is outside the valid range so needs to be
+                // wrapped back into it.
+                if (i < numSamples)
+                {
+                    value = wrapDelay(value + increment);
+                    destination[i++] = value;
+                }
+            }
+        }
+
+        /** Wraps the given delay value into the range 12 to delayLength + 12. */
+        float wrapDelay(float value) const
+        {
+            const auto period = static_cast<float>(delayLength);
+            return value - period * std::floor((value - 12.f) / period);
+        }
+
+        //==============================================================================================================
+        // The shortest supported window, in samples.
+        static constexpr int minWindowLength = 64;
+
+        std::vector<float> history;
+        int historySize = 0;
+        int writeIndex = 0;
+
+        const int maxDelay = 0;
+        const int maxBlockSize = 0;
+
+        // The state of each voice, all of which read from the same history.
+        struct Voice
+        {
+            float delay = 0.f;
+            float rate = 1.f;
+            float gain = 1.f;
+        };
+
+        std::array<Voice, maxVoices> voices;
+        int numVoices = 1;
 
-        float delay[2] = { 0.f, 0.f };
-        const float maxDelay = 0.f;
-        float envelope[2] = { 0.f, 0.f };
-        float rate = 1.f;
         int delayLength = 0;
         int halfLength = 0;
         float wetMix = 1.f;
         float dryMix = 0.f;
+
+        // Scratch buffers used when processing a block, allocated up front so
+        // nothing needs allocating on the audio thread.
+        // Each voice has two read heads.
+        std::vector<float> trajectories[maxVoices * 2];
+        std::vector<float> envelopes[maxVoices * 2];
+        std::vector<float> wetBuffer;
     };
 }   // namespace contrast
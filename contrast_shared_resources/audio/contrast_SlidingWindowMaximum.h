@@ -0,0 +1,112 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Finds the maximum of the most recent N values of a signal, where N is
+        the length of the window.
+
+        Only the values that could still become the maximum are kept, in
+        decreasing order: a new value removes every smaller value before it,
+        since those will leave the window first and can never be the maximum
+        again. The maximum is then always the oldest value kept, and each
+        value is added and removed at most once, so finding the maximum costs
+        the same however long the window is.
+
+        The storage is allocated up front for the maximum length given to the
+        constructor so this is safe to use on the audio thread.
+    */
+    template <typename ValueType>
+    class SlidingWindowMaximum
+    {
+    public:
+        //==============================================================================================================
+        explicit SlidingWindowMaximum(std::size_t maximumLength)
+            :   capacity(std::max<std::size_t>(1, maximumLength)),
+                values(capacity),
+                positions(capacity)
+        {
+        }
+
+        //==============================================================================================================
+        /** Sets the number of values in the window. This takes effect from
+            the next value processed.
+
+            Values that have already left the window are forgotten, so a
+            longer window only covers values from before the change up to the
+            old length, and fills up as new values are processed.
+        */
+        void setLength(std::size_t newLength)
+        {
+            jassert(newLength >= 1 && newLength <= capacity);
+            length = std::clamp<std::size_t>(newLength, 1, capacity);
+        }
+
+        /** Adds a new value to the window and returns the maximum of the
+            values now in the window.
+        */
+        ValueType process(ValueType newValue)
+        {
+            // Remove the oldest values once they've slid out of the window,
+            // which makes room for the new value.
+            while (size > 0 && positions[front] + length <= position)
+                popFront();
+
+            // Remove any values that are no bigger than the new one.
+            while (size > 0 && values[getBackIndex()] <= newValue)
+                size--;
+
+            const auto back = (front + size) % capacity;
+            values[back] = newValue;
+            positions[back] = position;
+            size++;
+            position++;
+
+            return values[front];
+        }
+
+        /** Fills the output with the maximum of the window after adding each
+            of the input values.
+        */
+        void process(const ValueType* input, ValueType* output, std::size_t numValues)
+        {
+            for (std::size_t i = 0; i < numValues; i++)
+                output[i] = process(input[i]);
+        }
+
+        /** Empties the window. */
+        void reset()
+        {
+            front = 0;
+            size = 0;
+        }
+
+    private:
+        //==============================================================================================================
+        std::size_t getBackIndex() const
+        {
+            return (front + size - 1) % capacity;
+        }
+
+        void popFront()
+        {
+            front = (front + 1) % capacity;
+            size--;
+        }
+
+        //==============================================================================================================
+        const std::size_t capacity;
+        std::size_t length = 1;
+
+        // The values that could still become the maximum, and the positions
+        // in the signal they were added at, stored as a ring buffer.
+        std::vector<ValueType> values;
+        std::vector<std::uint64_t> positions;
+        std::size_t front = 0;
+        std::size_t size = 0;
+
+        // The position in the signal of the next value.
+        std::uint64_t position = 0;
+    };
+}   // namespace contrast
@@ -0,0 +1,414 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** Changes the pitch of an audio signal with a low, user-controllable
+        latency.
+
+        Like PitchShifter, a read head moves through a history of the input
+        at a rate set by the shift. Instead of constantly crossfading between
+        two heads a fixed distance apart, the head is only moved when it's
+        about to leave the window, and it's moved to the point (roughly half a
+        window away) whose waveform best matches what the head has just read,
+        found by cross-correlation (WSOLA). A short crossfade covers the
+        splice. Since splices line up with the waveform, the window can be
+        made very short without the heavy comb-filtering of a plain delay-line
+        shifter, so the latency can be just a few milliseconds.
+
+        For long windows, the cross-correlation is calculated with an FFT.
+
+        Everything is allocated in the constructor, for the longest window,
+        so the window length can be changed without allocating.
+    */
+    class WsolaPitchShifter
+    {
+    public:
+        //==============================================================================================================
+        WsolaPitchShifter(double sampleRate, float maximumWindowLengthMS, int maximumBlockSize)
+            :   samplesPerMS(static_cast<float>(sampleRate / 1000.0)),
+                maxWindowLength(juce::jmax(minWindowLength, contrast::ceil(maximumWindowLengthMS * samplesPerMS))),
+                maxBlockSize(maximumBlockSize)
+        {
+            jassert(maximumBlockSize > 0);
+
+            // The history needs to hold the longest lag a head can have (a
+            // little over two windows when shifting up two octaves) as well
+            // as a whole block, since a block's input is written before it's
+            // read.
+            historySize = juce::nextPowerOfTwo(maxWindowLength * 3 + maximumBlockSize + minLag + 2);
+            history.resize(static_cast<std::size_t>(historySize), 0.f);
+
+            // Preallocate an FFT for every size the correlation might need so
+            // the window can be changed without allocating.
+            const auto maxFFTSize = juce::nextPowerOfTwo(2 * getSearchLength(maxWindowLength) + 1 + getOverlapLength(maxWindowLength));
+
+            for (auto order = minFFTOrder; (1 << order) <= maxFFTSize; order++)
+                ffts.push_back(std::make_unique<juce::dsp::FFT>(order));
+
+            templateBuffer   .resize(static_cast<std::size_t>(maxFFTSize * 2), 0.f);
+            candidateBuffer  .resize(static_cast<std::size_t>(maxFFTSize * 2), 0.f);
+            correlations     .resize(static_cast<std::size_t>(maxFFTSize), 0.f);
+            candidateEnergies.resize(static_cast<std::size_t>(maxFFTSize + 1), 0.f);
+
+            setWindowLength(maximumWindowLengthMS);
+        }
+
+        //==============================================================================================================
+        /** Processes the given samples in place. */
+        void process(float* samples, int numSamples)
+        {
+            // The history only has room for maxBlockSize samples ahead of
+            // the heads, so longer blocks are processed in chunks.
+            for (auto start = 0; start < numSamples; start += maxBlockSize)
+                processChunk(samples + start, juce::jmin(maxBlockSize, numSamples - start));
+        }
+
+        //==============================================================================================================
+        /** Sets the length of the window, in milliseconds, which determines
+            the latency of the effect. Shorter windows give lower latency but
+            more audible splices.
+        */
+        void setWindowLength(float newWindowLengthMS)
+        {
+            const auto newWindowLength = juce::jlimit(minWindowLength, maxWindowLength, contrast::ceil(newWindowLengthMS * samplesPerMS));
+
+            if (newWindowLength == windowLength)
+                return;
+
+            windowLength = newWindowLength;
+            overlapLength = getOverlapLength(windowLength);
+            searchLength = getSearchLength(windowLength);
+            latency = minLag + windowLength / 2;
+
+            // Start from the middle of the window.
+            lag = static_cast<float>(latency);
+            fadeRemaining = 0;
+        }
+
+        /** Returns the latency, in samples, introduced by the effect. */
+        int getLatency() const
+        {
+            return latency;
+        }
+
+        /** Sets the frequency shift of the pitch shifter.
+            This is essentially the number by which the frequency content of
+            the sound will be multiplied, so a shift of 2 will result in the
+            sound being an octave higher. Shifts above two octaves are
+            limited to two octaves.
+        */
+        void setShift(float newShift)
+        {
+            jassert(newShift > 0.f);
+            shift = juce::jlimit(0.f, maxShift, newShift);
+        }
+
+        /** Sets the amount of shift in frequency to use, in semitones and
+            cents.
+        */
+        void setShift(int semitones, float cents)
+        {
+            setShift(std::pow(2.f, (static_cast<float>(semitones) + cents / 100.f) / 12.f));
+        }
+
+        /** Sets the dry/wet mix for the effect.
+            Value must be 0 - 1 where 0 is dry and 1 is wet.
+        */
+        void setMix(float newMix)
+        {
+            jassert(newMix >= 0.f && newMix <= 1.f);
+
+            // Use the same sqrt law as PitchShifter so all the engines have the
+            // same loudness at a given mix.
+            wetMix = std::sqrt(newMix);
+            dryMix = std::sqrt(1.f - newMix);
+        }
+
+    private:
+        //==============================================================================================================
+        /** Processes a chunk of no more than maxBlockSize samples. */
+        void processChunk(float* samples, int numSamples)
+        {
+            // Write the whole chunk to the history first. Nothing is ever read
+            // from beyond the current sample so this is safe.
+            const auto firstWriteIndex = writeIndex;
+            const auto numBeforeWrap = juce::jmin(numSamples, historySize - writeIndex);
+            juce::FloatVectorOperations::copy(history.data() + writeIndex, samples, numBeforeWrap);
+            juce::FloatVectorOperations::copy(history.data(), samples + numBeforeWrap, numSamples - numBeforeWrap);
+            writeIndex = (writeIndex + numSamples) & (historySize - 1);
+
+            // Without a shift, once the head has settled at the nominal
+            // latency, the wet and dry signals are both just the delayed
+            // input.
+            if (shift == 1.f && fadeRemaining == 0 && lag == static_cast<float>(latency))
+            {
+                copyFromHistory(samples, firstWriteIndex, latency, numSamples);
+                juce::FloatVectorOperations::multiply(samples, wetMix + dryMix, numSamples);
+                return;
+            }
+
+            const auto mask = historySize - 1;
+            const auto rate = 1.f - shift;
+
+            for (auto i = 0; i < numSamples; i++)
+            {
+                const auto currentIndex = (firstWriteIndex + i) & mask;
+
+                if (fadeRemaining == 0 && needsSplice())
+                    splice(currentIndex);
+
+                auto wet = read(currentIndex, lag);
+
+                if (fadeRemaining > 0)
+                {
+                    const auto fadeIn = 1.f - static_cast<float>(fadeRemaining) / static_cast<float>(overlapLength);
+                    wet = fadeIn * wet + (1.f - fadeIn) * read(currentIndex, fadeLag);
+
+                    fadeLag += rate;
+                    fadeRemaining--;
+                }
+
+                lag += rate;
+
+                // Delay the dry signal by the nominal latency so it lines up
+                // with the wet signal.
+                const auto dry = history[static_cast<std::size_t>((currentIndex + historySize - latency) & mask)];
+                samples[i] = wetMix * wet + dryMix * dry;
+            }
+        }
+
+        /** Returns true if the read head is about to leave the window. The
+            head needs to be moved early enough that the old head is still
+            valid by the end of the crossfade.
+        */
+        bool needsSplice() const
+        {
+            if (shift > 1.f)
+                return lag < static_cast<float>(minLag) + static_cast<float>(overlapLength + 1) * (shift - 1.f);
+
+            if (shift < 1.f)
+                return lag > static_cast<float>(minLag + windowLength);
+
+            // Without a shift the head stays wherever the last shift left it,
+            // so it's moved back to the nominal latency.
+            return lag != static_cast<float>(latency);
+        }
+
+        /** Moves the read head half a window away, to the point that best
+            matches what the head has just read, and starts a crossfade from
+            the old position. Without a shift, the head is moved straight
+            back to the nominal latency instead.
+        */
+        void splice(int currentIndex)
+        {
+            if (shift == 1.f)
+            {
+                fadeLag = lag;
+                lag = static_cast<float>(latency);
+                fadeRemaining = overlapLength;
+                return;
+            }
+
+            // Above an octave the head moves so quickly that it has to jump
+            // further than half a window for the crossfade to finish before
+            // the next splice is due.
+            auto jump = windowLength / 2;
+
+            if (shift > 2.f)
+                jump = juce::jmax(jump, searchLength + contrast::ceil(static_cast<float>(overlapLength + 1) * (shift - 1.f)));
+
+            const auto wholeLag = static_cast<int>(lag);
+            const auto centre = shift > 1.f ? wholeLag + jump : juce::jmax(minLag + searchLength, wholeLag - jump);
+
+            const auto bestLag = findBestLag(currentIndex, wholeLag, centre - searchLength, centre + searchLength);
+
+            fadeLag = lag;
+            lag = static_cast<float>(bestLag) + (lag - static_cast<float>(wholeLag));
+            fadeRemaining = overlapLength;
+        }
+
+        /** Returns the lag, between the given limits, whose preceding
+            overlapLength samples are most similar to those preceding the
+            given lag, using a normalised cross-correlation.
+        */
+        int findBestLag(int currentIndex, int currentLag, int minCandidateLag, int maxCandidateLag)
+        {
+            const auto numCandidates = maxCandidateLag - minCandidateLag + 1;
+
+            // The template is the overlapLength samples ending at the current
+            // head position. The candidates all lie within a single segment
+            // of the history, oldest first, so candidate k ends at lag
+            // maxCandidateLag - k.
+            copyFromHistory(templateBuffer.data(), currentIndex, currentLag + overlapLength - 1, overlapLength);
+            copyFromHistory(candidateBuffer.data(), currentIndex, maxCandidateLag + overlapLength - 1, numCandidates + overlapLength - 1);
+
+            // Calculate the energy of each candidate using a running sum.
+            candidateEnergies[0] = 0.f;
+
+            for (auto i = 0; i < numCandidates + overlapLength - 1; i++)
+            {
+                const auto value = candidateBuffer[static_cast<std::size_t>(i)];
+                candidateEnergies[static_cast<std::size_t>(i + 1)] = candidateEnergies[static_cast<std::size_t>(i)] + value * value;
+            }
+
+            const auto fftSize = juce::nextPowerOfTwo(numCandidates + overlapLength);
+            const auto fftOrder = juce::roundToInt(std::log2(static_cast<double>(fftSize)));
+
+            // Only use an FFT when it's likely to be cheaper than correlating
+            // directly.
+            if (fftOrder >= minFFTOrder && static_cast<long>(numCandidates) * overlapLength > 4L * fftSize * fftOrder)
+                correlateWithFFT(numCandidates, fftOrder);
+            else
+                correlateDirectly(numCandidates);
+
+            auto bestCandidate = 0;
+            auto bestScore = std::numeric_limits<float>::lowest();
+
+            for (auto k = 0; k < numCandidates; k++)
+            {
+                const auto energy = candidateEnergies[static_cast<std::size_t>(k + overlapLength)] - candidateEnergies[static_cast<std::size_t>(k)];
+                const auto score = correlations[static_cast<std::size_t>(k)] / std::sqrt(juce::jmax(energy, 0.f) + 1.0e-9f);
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestCandidate = k;
+                }
+            }
+
+            return maxCandidateLag - bestCandidate;
+        }
+
+        /** Correlates the template with each candidate directly. */
+        void correlateDirectly(int numCandidates)
+        {
+            for (auto k = 0; k < numCandidates; k++)
+            {
+                auto sum = 0.f;
+
+                for (auto i = 0; i < overlapLength; i++)
+                    sum += templateBuffer[static_cast<std::size_t>(i)] * candidateBuffer[static_cast<std::size_t>(k + i)];
+
+                correlations[static_cast<std::size_t>(k)] = sum;
+            }
+        }
+
+        /** Correlates the template with each candidate by multiplying their
+            spectra.
+        */
+        void correlateWithFFT(int numCandidates, int fftOrder)
+        {
+            const auto& fft = *ffts[static_cast<std::size_t>(fftOrder - minFFTOrder)];
+            const auto fftSize = fft.getSize();
+
+            std::fill(templateBuffer.begin() + overlapLength, templateBuffer.begin() + fftSize * 2, 0.f);
+            std::fill(candidateBuffer.begin() + numCandidates + overlapLength - 1, candidateBuffer.begin() + fftSize * 2, 0.f);
+
+            fft.performRealOnlyForwardTransform(templateBuffer.data(), true);
+            fft.performRealOnlyForwardTransform(candidateBuffer.data(), true);
+
+            // Multiply the candidates' spectrum by the conjugate of the
+            // template's spectrum.
+            for (auto bin = 0; bin <= fftSize / 2; bin++)
+            {
+                const auto index = static_cast<std::size_t>(bin * 2);
+                const std::complex<float> templateBin{ templateBuffer[index], templateBuffer[index + 1] };
+                const std::complex<float> candidateBin{ candidateBuffer[index], candidateBuffer[index + 1] };
+                const auto product = candidateBin * std::conj(templateBin);
+
+                candidateBuffer[index] = product.real();
+                candidateBuffer[index + 1] = product.imag();
+            }
+
+            fft.performRealOnlyInverseTransform(candidateBuffer.data());
+            std::copy(candidateBuffer.begin(), candidateBuffer.begin() + numCandidates, correlations.begin());
+        }
+
+        /** Copies the given number of samples from the history, starting
+            with the sample at the given lag and moving forwards in time.
+        */
+        void copyFromHistory(float* destination, int currentIndex, int startLag, int numSamples) const
+        {
+            const auto mask = historySize - 1;
+
+            for (auto i = 0; i < numSamples; i++)
+                destination[i] = history[static_cast<std::size_t>((currentIndex + historySize - startLag + i) & mask)];
+        }
+
+        /** Reads from the history at the given, fractional, lag behind the
+            sample at the given index.
+        */
+        float read(int currentIndex, float lagToRead) const
+        {
+            const auto mask = historySize - 1;
+            const auto wholeLag = static_cast<int>(lagToRead);
+            const auto fraction = lagToRead - static_cast<float>(wholeLag);
+            const auto index = (currentIndex + historySize - wholeLag) & mask;
+
+            const auto newer = history[static_cast<std::size_t>(index)];
+            const auto older = history[static_cast<std::size_t>((index + mask) & mask)];
+
+            return newer + fraction * (older - newer);
+        }
+
+        //==============================================================================================================
+        static int getOverlapLength(int window)
+        {
+            return juce::jmax(1, window / 4);
+        }
+
+        static int getSearchLength(int window)
+        {
+            return juce::jmax(1, window / 4);
+        }
+
+        //==============================================================================================================
+        // The highest supported shift (two octaves up).
+        static constexpr float maxShift = 4.f;
+
+        // The shortest supported window, in samples.
+        static constexpr int minWindowLength = 16;
+
+        // The smallest FFT used for correlation. Anything smaller is always
+        // cheaper to correlate directly.
+        static constexpr int minFFTOrder = 4;
+
+        // The closest a read head is allowed to get to the most recent input.
+        static constexpr int minLag = 2;
+
+        const float samplesPerMS;
+        const int maxWindowLength;
+        const int maxBlockSize;
+
+        std::vector<float> history;
+        int historySize = 0;
+        int writeIndex = 0;
+
+        int windowLength = 0;
+        int overlapLength = 0;
+        int searchLength = 0;
+        int latency = 0;
+
+        // The lag, in samples, of the read head and, during a crossfade, of
+        // the head being faded out.
+        float lag = 0.f;
+        float fadeLag = 0.f;
+        int fadeRemaining = 0;
+
+        float shift = 1.f;
+        float wetMix = 1.f;
+        float dryMix = 0.f;
+
+        // Scratch buffers and FFTs used to find splice points.
+        std::vector<std::unique_ptr<juce::dsp::FFT>> ffts;
+        std::vector<float> templateBuffer;
+        std::vector<float> candidateBuffer;
+        std::vector<float> correlations;
+        std::vector<float> candidateEnergies;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WsolaPitchShifter)
+    };
+}   // namespace contrast
@@ -65,11 +65,23 @@ namespace contrast
 // Contrast includes.
 #include "utilities/contrast_functions.h"
 #include "utilities/contrast_PluginProcessor.h"
+#include "utilities/contrast_WorkerPool.h"
+#include "utilities/contrast_LockFreeFifo.h"
 
 #include "audio/contrast_EnvelopeFollower.h"
+#include "audio/contrast_Biquad.h"
+#include "audio/contrast_LinkwitzRileyCrossover.h"
 #include "audio/contrast_Compressor.h"
 #include "audio/contrast_DelayLine.h"
+#include "audio/contrast_SlidingWindowMaximum.h"
 #include "audio/contrast_PitchShifter.h"
+#include "audio/contrast_PhaseVocoder.h"
+#include "audio/contrast_WsolaPitchShifter.h"
+#include "audio/contrast_HalfBandResampler.h"
+#include "audio/contrast_EarlyReflections.h"
+#include "audio/contrast_FeedbackDelayNetwork.h"
+#include "audio/contrast_PartitionedConvolver.h"
+#include "audio/contrast_ImpulseResponseCache.h"
 
 #include "graphics/contrast_LookAndFeel.h"
 #include "graphics/icons/contrast_Icons.h"
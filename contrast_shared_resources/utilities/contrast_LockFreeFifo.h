@@ -0,0 +1,80 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** A fixed-size queue for passing values from one thread to another,
+        such as from the audio thread to the message thread.
+
+        There must only be one thread pushing values and one thread popping
+        them. Neither ever waits for the other, so it's safe to push from the
+        audio thread. When the queue is full, new values are dropped rather
+        than overwriting ones that haven't been read yet.
+    */
+    template <typename ValueType>
+    class LockFreeFifo
+    {
+    public:
+        //==============================================================================================================
+        /** Creates a queue that can hold the given number of values. */
+        explicit LockFreeFifo(int capacity)
+            :   fifo(capacity + 1),
+                values(static_cast<std::size_t>(capacity + 1))
+        {
+        }
+
+        //==============================================================================================================
+        /** Adds a value to the queue. Returns false, and drops the value, if
+            the queue is full.
+
+            This should only be called from the producer thread.
+        */
+        bool push(const ValueType& value)
+        {
+            const juce::AbstractFifo::ScopedWrite write(fifo, 1);
+
+            if (write.blockSize1 > 0)
+                values[static_cast<std::size_t>(write.startIndex1)] = value;
+            else if (write.blockSize2 > 0)
+                values[static_cast<std::size_t>(write.startIndex2)] = value;
+            else
+                return false;
+
+            return true;
+        }
+
+        /** Takes the oldest value from the queue. Returns false, and leaves
+            the given value untouched, if the queue is empty.
+
+            This should only be called from the consumer thread.
+        */
+        bool pop(ValueType& value)
+        {
+            const juce::AbstractFifo::ScopedRead read(fifo, 1);
+
+            if (read.blockSize1 > 0)
+                value = values[static_cast<std::size_t>(read.startIndex1)];
+            else if (read.blockSize2 > 0)
+                value = values[static_cast<std::size_t>(read.startIndex2)];
+            else
+                return false;
+
+            return true;
+        }
+
+        /** Returns the number of values waiting to be popped. */
+        int getNumReady() const noexcept
+        {
+            return fifo.getNumReady();
+        }
+
+    private:
+        //==============================================================================================================
+        juce::AbstractFifo fifo;
+        std::vector<ValueType> values;
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LockFreeFifo)
+    };
+}   // namespace contrast
@@ -0,0 +1,264 @@
+#pragma once
+
+//======================================================================================================================
+namespace contrast
+{
+    //==================================================================================================================
+    /** A pool of background threads shared by every plugin instance in the
+        process, for work that's too heavy for the audio thread such as the
+        tails of long convolutions.
+
+        Use a juce::SharedResourcePointer<WorkerPool> to access the pool so
+        that all instances share the same threads, rather than each one
+        starting its own and oversubscribing the CPU.
+
+        Work is given to the pool through clients. Each client keeps its own
+        queue of pending jobs, usually a lock-free ring filled by the audio
+        thread, and the pool's workers ask the clients for the deadline of
+        their next job. The client with the highest priority, and then the
+        earliest deadline, is given the next free worker. A client's jobs are
+        only ever run by one worker at a time, so its queue only needs a
+        single consumer.
+
+        Clients call notify() after adding a job, which only increments an
+        atomic counter so it never blocks the audio thread. Idle workers check
+        the counter every millisecond, so the clients are only asked for
+        their deadlines when there might be something to do. The workers run
+        at a raised priority since their jobs are usually needed by the audio
+        thread.
+    */
+    class WorkerPool
+    {
+    public:
+        //==============================================================================================================
+        enum class Priority
+        {
+            low,
+            normal,
+            high
+        };
+
+        //==============================================================================================================
+        /** Something with work for the pool to do. */
+        class Client
+        {
+        public:
+            //==========================================================================================================
+            virtual ~Client() = default;
+
+            //==========================================================================================================
+            /** Returns the time, in milliseconds as given by
+                juce::Time::getMillisecondCounterHiRes(), by which this
+                client's next job should be finished, or std::nullopt if it
+                has no pending jobs.
+
+                This is called from the pool's worker threads.
+            */
+            virtual std::optional<double> getNextDeadline() = 0;
+
+            /** Runs this client's next pending job.
+
+                This is called from the pool's worker threads.
+            */
+            virtual void runNextJob() = 0;
+
+            /** Returns the priority of this client's jobs. Jobs from clients
+                with a higher priority are always run before jobs from clients
+                with a lower priority, regardless of their deadlines.
+            */
+            virtual Priority getPriority() const
+            {
+                return Priority::normal;
+            }
+
+        private:
+            //==========================================================================================================
+            friend class WorkerPool;
+            std::atomic<bool> isRunning{ false };
+        };
+
+        //==============================================================================================================
+        WorkerPool()
+        {
+            // Leave a core free for the audio thread.
+            const auto numWorkers = juce::jlimit(1, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+
+            for (auto i = 0; i < numWorkers; i++)
+            {
+                workers.add(new Worker(*this));
+                workers.getLast()->startThread(juce::Thread::Priority::highest);
+            }
+        }
+
+        ~WorkerPool()
+        {
+            // All clients should have been removed by now.
+            jassert(clients.isEmpty());
+
+            for (auto* worker : workers)
+                worker->signalThreadShouldExit();
+
+            for (auto* worker : workers)
+                worker->stopThread(1000);
+        }
+
+        //==============================================================================================================
+        /** Adds a client whose jobs will be run by the pool. This shouldn't be
+            called from the audio thread.
+        */
+        void addClient(Client& client)
+        {
+            const juce::ScopedLock lock(clientsMutex);
+            clients.addIfNotAlreadyThere(&client);
+        }
+
+        /** Removes a client from the pool, waiting for any of its jobs that are
+            running to finish. This shouldn't be called from the audio thread,
+            and must be called before the client is destroyed.
+        */
+        void removeClient(Client& client)
+        {
+            {
+                const juce::ScopedLock lock(clientsMutex);
+                clients.removeFirstMatchingValue(&client);
+            }
+
+            while (client.isRunning.load(std::memory_order_acquire))
+                juce::Thread::yield();
+        }
+
+        /** Tells the pool's idle workers to look for pending jobs. Clients
+            should call this each time they add a job. This is lock-free so
+            it's safe to call from the audio thread.
+        */
+        void notify()
+        {
+            numNotifications.fetch_add(1, std::memory_order_release);
+        }
+
+        /** Returns the number of threads in the pool. */
+        int getNumWorkers() const
+        {
+            return workers.size();
+        }
+
+    private:
+        //==============================================================================================================
+        class Worker    :   public juce::Thread
+        {
+        public:
+            explicit Worker(WorkerPool& poolToUse)
+                :   juce::Thread("Contrast Worker"),
+                    pool(poolToUse)
+            {
+            }
+
+            void run() override
+            {
+                while (! threadShouldExit())
+                {
+                    // Each notification wakes one worker, which keeps running
+                    // jobs until there are none left.
+                    if (! pool.claimNotification())
+                    {
+                        wait(idleWaitTime);
+                        continue;
+                    }
+
+                    while (! threadShouldExit() && pool.runNextJob())
+                    {
+                    }
+                }
+            }
+
+        private:
+            WorkerPool& pool;
+        };
+
+        //==============================================================================================================
+        /** Takes one of the notifications given by clients. Returns false if
+            there weren't any.
+        */
+        bool claimNotification()
+        {
+            auto expected = numNotifications.load(std::memory_order_acquire);
+
+            while (expected > 0)
+            {
+                if (numNotifications.compare_exchange_weak(expected, expected - 1, std::memory_order_acq_rel))
+                    return true;
+            }
+
+            return false;
+        }
+
+        /** Finds the most urgent pending job and runs it. Returns false if
+            there was nothing to do.
+        */
+        bool runNextJob()
+        {
+            Client* next = nullptr;
+
+            {
+                const juce::ScopedLock lock(clientsMutex);
+
+                auto nextPriority = Priority::low;
+                auto nextDeadline = 0.0;
+
+                for (auto* client : clients)
+                {
+                    // Another worker is already running this client's jobs.
+                    if (client->isRunning.load(std::memory_order_acquire))
+                        continue;
+
+                    const auto deadline = client->getNextDeadline();
+
+                    if (! deadline.has_value())
+                        continue;
+
+                    const auto priority = client->getPriority();
+
+                    if (next == nullptr
+                        || priority > nextPriority
+                        || (priority == nextPriority && *deadline < nextDeadline))
+                    {
+                        next = client;
+                        nextPriority = priority;
+                        nextDeadline = *deadline;
+                    }
+                }
+
+                if (next == nullptr)
+                    return false;
+
+                // Claim the client while the lock is held so it can't be
+                // removed or picked by another worker.
+                next->isRunning.store(true, std::memory_order_release);
+            }
+
+            next->runNextJob();
+            next->isRunning.store(false, std::memory_order_release);
+
+            return true;
+        }
+
+        //==============================================================================================================
+        static constexpr int maxWorkers = 8;
+
+        // How long, in milliseconds, idle workers sleep between checking for
+        // notifications.
+        static constexpr int idleWaitTime = 1;
+
+        juce::CriticalSection clientsMutex;
+        juce::Array<Client*> clients;
+
+        juce::OwnedArray<Worker> workers;
+
+        // The number of times clients have called notify() that haven't yet
+        // been picked up by a worker.
+        std::atomic<int> numNotifications{ 0 };
+
+        //==============================================================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkerPool)
+    };
+}   // namespace contrast